@@ -0,0 +1,63 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/**
+ * @file bench.h
+ * @brief 捕获和控制热路径的基准测试
+ * @note 每个用例循环调用 BENCH_ITERS 次，输出每次调用的周期数、指令数和耗时，一行一个JSON对象:
+ *       {"bench":"pid_update_float","platform":"host","rev":"d5d4ad7","iters":1000000,"cycles":12.34,"instructions":45.00,"ns":3.21}
+ *       主机: 用 perf_event 统计周期和指令，不可用时这两项为 null
+ *       目标板: 用 DWT 周期计数器统计周期，指令数为 null，结果从 ITM 端口0 (SWO) 输出
+ *       结果中包含循环本身的开销，见 loop_overhead 用例
+ */
+#include "stdint.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef BENCH_ITERS
+#if defined(__arm__)
+#define BENCH_ITERS 1000UL // 目标板每个用例的调用次数
+#else
+#define BENCH_ITERS 1000000UL // 主机每个用例的调用次数
+#endif
+#endif
+
+#ifndef BENCH_REV
+#define BENCH_REV "unknown" // 由构建系统传入提交号
+#endif
+
+typedef struct
+{
+    uint64_t cycles;       // 周期数
+    uint64_t instructions; // 指令数
+    uint64_t ns;           // 耗时 单位: 纳秒
+    uint8_t hasCycles;     // 周期数有效
+    uint8_t hasInstructions; // 指令数有效
+} bench_Sample_t;
+
+/* 平台相关，由 bench_host.c / bench_target.c 实现 */
+void bench_PlatformInit(void);
+void bench_Begin(void);
+void bench_End(bench_Sample_t *sample);
+void bench_Write(const char *line);
+const char *bench_Platform(void);
+
+/* 用例 */
+typedef void (*bench_Fn_t)(uint32_t iters);
+
+void bench_Report(const char *name, uint32_t iters, uint32_t callsPerIter, const bench_Sample_t *sample);
+void bench_Measure(const char *name, bench_Fn_t fn, uint32_t iters, uint32_t callsPerIter);
+void bench_Run(void);
+
+/* C++ 封装的用例，在 bench_cpp.cpp 中 */
+void bench_CppSetup(void);
+void bench_CppCaptureCallback(uint32_t iters);
+void bench_CppPidUpdate(uint32_t iters);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // !BENCH_H
@@ -0,0 +1,325 @@
+/**
+ * @file bench_accuracy.c
+ * @brief 捕获精度基准，在主机仿真上与理论值比较
+ * @note 场景: 频率/占空比扫描、线性啁啾、边沿抖动、频率阶跃
+ *       模式: it (HAL回调 + pwmCapture_Callback，每个样本完成即取走，如 pidLink)
+ *             static (pwmCapture_static.h 的编译期特化中断)
+ *             it_poll_1khz (与 it 相同的捕获，主循环每1ms查询一次 getComplete，如 main.c 中的示例)
+ *       仿真中断没有执行时间，各模式的差别在于数据取走的方式；DMA、平均模式在本仓库中没有实现
+ *       理论值: 在下降沿完成的样本，频率对应刚结束的周期(前后两个上升沿)，占空比为当前周期的高电平/周期
+ *       每个 场景 x 模式 x 参数 输出一行JSON:
+ *         freq_err_pct      频率相对误差最大值 (%)
+ *         duty_err_pp       占空比误差最大值 (百分点)
+ *         duty_err_rms_pp   占空比误差均方根
+ *         lost              应完成而未完成的样本数
+ *         settle_samples    阶跃后相对新的标称值，频率误差<1%且占空比误差<1个百分点连续3个样本，
+ *                           第一个满足的样本距阶跃的样本数，仅阶跃场景
+ */
+#include "sim_tim.h"
+#include "tim.h"
+#include "pwmCapture.h"
+#include "pwmCapture_static.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "math.h"
+
+#ifndef BENCH_REV
+#define BENCH_REV "unknown"
+#endif
+
+#define ACC_MAX_PULSES 4096
+#define ACC_POLL_PERIOD 1e-3 // 查询模式的主循环周期 单位: 秒
+
+PWM_CAPTURE_DEFINE_EX(accStatic, TIM1, CH1, CH2, CAPTURE_TICK_HZ)
+PWM_CAPTURE_INSTANCE(accStatic);
+
+typedef enum
+{
+    ACC_MODE_IT = 0,
+    ACC_MODE_STATIC,
+    ACC_MODE_IT_POLL,
+} acc_Mode_t;
+
+static const char *const accModeName[] = { "it", "static", "it_poll_1khz" };
+
+typedef struct
+{
+    double period; // 单位: 秒
+    double high;   // 单位: 秒
+} acc_Pulse_t;
+
+typedef struct
+{
+    unsigned long samples;
+    unsigned long lost;
+    double freqErrMax;
+    double dutyErrMax;
+    double dutyErrSq;
+    long settle;
+} acc_Stat_t;
+
+static pwm_Capture_Handle_t accCap = NULL;
+static pwm_Capture_Class_t accCapObj;
+static acc_Pulse_t accPulse[ACC_MAX_PULSES];
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1)
+    {
+        pwmCapture_Callback(&accCap, htim);
+    }
+}
+
+static void acc_StaticIRQ(void)
+{
+    accStatic_IRQHandler();
+}
+
+static void acc_Setup(acc_Mode_t mode)
+{
+    simTim_Reset();
+    TIM1->PSC = CAPTURE_TIM_PSC;
+    TIM1->ARR = CAPTURE_TIM_ARR;
+    accCap = NULL;
+
+    if (mode != ACC_MODE_STATIC)
+    {
+        pwm_Capture_conf_t conf = {
+            .htim = &htim1,
+            .RiseChannel = TIM_CHANNEL_1,
+            .FallChannel = TIM_CHANNEL_2,
+            .tickHz = CAPTURE_TICK_HZ,
+            .mode = PWM_CAPTURE_MODE_CONTINUOUS,
+        };
+        pwmCapture_InitStatic(&accCap, &accCapObj, &conf);
+    }
+    else
+    {
+        memset(&accStatic, 0, sizeof(accStatic));
+        simTim_SetIRQ(&htim1, acc_StaticIRQ);
+        accStatic_Start();
+    }
+}
+
+/* 样本是否已完成，未取走 */
+static uint32_t acc_Seq(acc_Mode_t mode, uint32_t staticSeq)
+{
+    return (mode == ACC_MODE_STATIC) ? staticSeq + accStatic.isCapComplete : accCap->seq;
+}
+
+/* 取走样本 */
+static void acc_Take(acc_Mode_t mode, pwm_Capture_Result_t *r)
+{
+    if (mode == ACC_MODE_STATIC)
+    {
+        accStatic_getComplete();
+        *r = accStatic.result;
+    }
+    else
+    {
+        pwmCapture_getComplete(&accCap);
+        *r = accCap->result;
+    }
+}
+
+/**
+ * @brief 输入一串脉冲并统计误差
+ *
+ * @param mode 模式
+ * @param p 脉冲，第一个周期只作为起点，不计入统计
+ * @param n 脉冲数
+ * @param step 阶跃所在的脉冲序号，无阶跃时为0
+ * @param stat 统计结果
+ */
+static void acc_Run(acc_Mode_t mode, const acc_Pulse_t *p, size_t n, size_t step, acc_Stat_t *stat)
+{
+    const double clk = (double)SystemCoreClock;
+    double t = 1e-3; // 第一个上升沿前留出1ms
+    double nextPoll = 0.0;
+    uint32_t seq = 0, takenSeq = 0, staticSeq = 0;
+    unsigned long good = 0;
+    size_t i, done = 0; // done: 最近完成的样本所在的脉冲序号
+    int pending = 0;
+
+    memset(stat, 0, sizeof(*stat));
+    stat->settle = -1;
+    acc_Setup(mode);
+
+    for (i = 0; i < n; i++)
+    {
+        int valid = (p[i].high > 0.0 && p[i].high < p[i].period);
+        double edgeT;
+
+        simTim_Edge(&htim1, 1, (uint64_t)llround(t * clk));
+        edgeT = t;
+        if (valid)
+        {
+            simTim_Edge(&htim1, 0, (uint64_t)llround((t + p[i].high) * clk));
+            edgeT = t + p[i].high;
+        }
+
+        if (acc_Seq(mode, staticSeq) != seq)
+        {
+            pwm_Capture_Result_t r;
+
+            seq = acc_Seq(mode, staticSeq);
+            done = i;
+            pending = (i > 0 && valid);
+            if (!pending) // 第一个样本没有完整周期，取走不计入
+            {
+                acc_Take(mode, &r);
+                if (mode == ACC_MODE_STATIC) staticSeq++;
+                takenSeq = seq;
+            }
+        }
+        else if (i > 0 && valid)
+        {
+            stat->lost++; // 应完成而未完成
+        }
+
+        if (pending && (mode != ACC_MODE_IT_POLL || edgeT >= nextPoll))
+        {
+            pwm_Capture_Result_t r;
+            double f = 1.0 / p[done - 1].period;
+            double fe, de;
+
+            acc_Take(mode, &r);
+            if (mode == ACC_MODE_STATIC) staticSeq++;
+            if (takenSeq != 0 && seq - takenSeq > 1) stat->lost += seq - takenSeq - 1; // 未取走就被覆盖
+            takenSeq = seq;
+            pending = 0;
+            if (mode == ACC_MODE_IT_POLL)
+            {
+                while (nextPoll <= edgeT) nextPoll += ACC_POLL_PERIOD;
+            }
+
+            fe = fabs((double)r.freq - f) / f * 100.0;
+            de = fabs((double)r.duty - p[done].high / p[done].period * 100.0);
+            stat->samples++;
+            if (fe > stat->freqErrMax) stat->freqErrMax = fe;
+            if (de > stat->dutyErrMax) stat->dutyErrMax = de;
+            stat->dutyErrSq += de * de;
+
+            /* 阶跃后与新的标称值比较 */
+            if (step != 0 && done >= step && stat->settle < 0)
+            {
+                double fn = 1.0 / p[step].period;
+                double dn = p[step].high / p[step].period * 100.0;
+                if (fabs((double)r.freq - fn) / fn * 100.0 < 1.0 && fabs((double)r.duty - dn) < 1.0)
+                {
+                    if (++good == 3) stat->settle = (long)(done - step) - 2;
+                }
+                else
+                {
+                    good = 0;
+                }
+            }
+        }
+        t += p[i].period;
+    }
+}
+
+static void acc_Report(const char *scenario, acc_Mode_t mode, const char *param, const acc_Stat_t *s)
+{
+    double rms = s->samples ? sqrt(s->dutyErrSq / (double)s->samples) : 0.0;
+
+    printf("{\"bench\":\"accuracy\",\"scenario\":\"%s\",\"mode\":\"%s\",\"rev\":\"%s\",%s,"
+           "\"samples\":%lu,\"lost\":%lu,\"freq_err_pct\":%.4f,\"duty_err_pp\":%.4f,\"duty_err_rms_pp\":%.4f",
+           scenario, accModeName[mode], BENCH_REV, param, s->samples, s->lost, s->freqErrMax, s->dutyErrMax, rms);
+    if (s->settle != -1 || strcmp(scenario, "step") == 0)
+    {
+        printf(",\"settle_samples\":%ld", s->settle);
+    }
+    printf("}\n");
+}
+
+/* 标准正态分布随机数 (Box-Muller)，固定种子保证结果可重复 */
+static double acc_Gauss(void)
+{
+    double u1 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+    double u2 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * 3.14159265358979 * u2);
+}
+
+int main(void)
+{
+    static const double freqs[] = { 20, 50, 100, 200, 500, 1000, 2000, 3000, 5000 };
+    static const double duties[] = { 1, 10, 50, 90, 99 };
+    static const double jitters[] = { 0.0001, 0.001, 0.01 };
+    char param[96];
+    acc_Stat_t stat;
+    size_t i, j, n;
+    int m;
+
+    for (m = ACC_MODE_IT; m <= ACC_MODE_IT_POLL; m++)
+    {
+        /* 扫描 */
+        for (i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++)
+        {
+            for (j = 0; j < sizeof(duties) / sizeof(duties[0]); j++)
+            {
+                n = 64;
+                for (size_t k = 0; k < n; k++)
+                {
+                    accPulse[k].period = 1.0 / freqs[i];
+                    accPulse[k].high = accPulse[k].period * duties[j] / 100.0;
+                }
+                acc_Run((acc_Mode_t)m, accPulse, n, 0, &stat);
+                snprintf(param, sizeof(param), "\"freq_hz\":%.0f,\"duty_pct\":%.0f", freqs[i], duties[j]);
+                acc_Report("sweep", (acc_Mode_t)m, param, &stat);
+            }
+        }
+
+        /* 啁啾: 100Hz -> 2000Hz 线性，1秒，占空比30% */
+        {
+            double t = 0.0;
+            n = 0;
+            while (t < 1.0 && n < ACC_MAX_PULSES)
+            {
+                double f = 100.0 + 1900.0 * t;
+                accPulse[n].period = 1.0 / f;
+                accPulse[n].high = accPulse[n].period * 0.3;
+                t += accPulse[n].period;
+                n++;
+            }
+            acc_Run((acc_Mode_t)m, accPulse, n, 0, &stat);
+            acc_Report("chirp", (acc_Mode_t)m, "\"freq_hz\":\"100-2000\",\"duty_pct\":30", &stat);
+        }
+
+        /* 抖动: 1kHz 50%，每个边沿加正态抖动 */
+        for (i = 0; i < sizeof(jitters) / sizeof(jitters[0]); i++)
+        {
+            double prevRise = 0.0;
+            srand(1);
+            n = 1024;
+            for (j = 0; j < n; j++)
+            {
+                double rise = (double)(j + 1) * 1e-3 + acc_Gauss() * jitters[i] * 1e-3;
+                double fall = rise + 0.5e-3 + acc_Gauss() * jitters[i] * 1e-3;
+                if (j > 0)
+                {
+                    accPulse[j - 1].period = rise - prevRise;
+                }
+                accPulse[j].high = fall - rise;
+                accPulse[j].period = 1e-3;
+                prevRise = rise;
+            }
+            acc_Run((acc_Mode_t)m, accPulse, n, 0, &stat);
+            snprintf(param, sizeof(param), "\"freq_hz\":1000,\"duty_pct\":50,\"jitter_pct\":%.2f", jitters[i] * 100.0);
+            acc_Report("jitter", (acc_Mode_t)m, param, &stat);
+        }
+
+        /* 阶跃: 500Hz -> 1500Hz */
+        n = 128;
+        for (j = 0; j < n; j++)
+        {
+            accPulse[j].period = (j < 64) ? 1.0 / 500.0 : 1.0 / 1500.0;
+            accPulse[j].high = accPulse[j].period * 0.5;
+        }
+        acc_Run((acc_Mode_t)m, accPulse, n, 64, &stat);
+        acc_Report("step", (acc_Mode_t)m, "\"freq_hz\":\"500-1500\",\"duty_pct\":50", &stat);
+    }
+
+    return 0;
+}
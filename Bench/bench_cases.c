@@ -0,0 +1,261 @@
+#include "bench.h"
+#include "main.h"
+#include "pwmCapture.h"
+#include "pwmCapture_static.h"
+#include "PID.h"
+#include "PIDBatch.h"
+#include "stdio.h"
+#include "string.h"
+
+#ifndef BENCH_PID_NUM
+#define BENCH_PID_NUM 8 // 批量与逐个更新对比的控制器数量
+#endif
+
+/* 内存中的定时器寄存器，回调只读写寄存器，不需要真实的外设 */
+static TIM_TypeDef benchTim;
+static TIM_HandleTypeDef benchHtim;
+static pwm_Capture_Class_t benchCapObj;
+static pwm_Capture_Handle_t benchCap = NULL;
+
+static TIM_TypeDef benchTimStatic;
+PWM_CAPTURE_DEFINE(benchStatic, (&benchTimStatic), CH1, CH2)
+PWM_CAPTURE_INSTANCE(benchStatic);
+
+static PIDController_Class_t benchPidObj[BENCH_PID_NUM];
+static PIDController_Handle_t benchPid[BENCH_PID_NUM];
+static PIDController_Q_Handle_t benchPidQ = NULL;
+static PIDBatch_Handle_t benchBatch = NULL;
+
+static PIDController_Conf_t benchPidConf = {
+    .kp = 4.65f,
+    .ki = 0.01f,
+    .kd = 0.10f,
+    .limMin = 0.0f,
+    .limMax = 100.0f,
+    .tau = 0.02f,
+    .T = 0.0005f,
+    .limMinInt = -5.0f,
+    .limMaxInt = 10.0f,
+};
+
+volatile uint32_t benchSink; // 防止结果被优化掉
+volatile float benchSinkF;
+
+/**
+ * @brief 按用例名输出一行JSON
+ *
+ * @param name 用例名
+ * @param iters 循环次数
+ * @param callsPerIter 每次循环的调用次数，结果按调用次数平均
+ * @param sample 测量值
+ */
+void bench_Report(const char *name, uint32_t iters, uint32_t callsPerIter, const bench_Sample_t *sample)
+{
+    char line[192];
+    char cycles[24] = "null";
+    char instructions[24] = "null";
+    uint64_t calls = (uint64_t)iters * callsPerIter;
+    uint32_t v;
+
+    /* 保留两位小数，只用整数格式化，目标板不需要浮点printf */
+    if (sample->hasCycles)
+    {
+        v = (uint32_t)(sample->cycles * 100U / calls);
+        snprintf(cycles, sizeof(cycles), "%lu.%02lu", (unsigned long)(v / 100U), (unsigned long)(v % 100U));
+    }
+    if (sample->hasInstructions)
+    {
+        v = (uint32_t)(sample->instructions * 100U / calls);
+        snprintf(instructions, sizeof(instructions), "%lu.%02lu", (unsigned long)(v / 100U), (unsigned long)(v % 100U));
+    }
+    v = (uint32_t)(sample->ns * 100U / calls);
+
+    snprintf(line, sizeof(line),
+             "{\"bench\":\"%s\",\"platform\":\"%s\",\"rev\":\"%s\",\"iters\":%lu,\"cycles\":%s,\"instructions\":%s,\"ns\":%lu.%02lu}\n",
+             name, bench_Platform(), BENCH_REV, (unsigned long)calls, cycles, instructions,
+             (unsigned long)(v / 100U), (unsigned long)(v % 100U));
+    bench_Write(line);
+}
+
+/**
+ * @brief 运行并输出一个用例，先预热一次
+ */
+void bench_Measure(const char *name, bench_Fn_t fn, uint32_t iters, uint32_t callsPerIter)
+{
+    bench_Sample_t sample;
+
+    fn(iters / 16U + 1U);
+    bench_Begin();
+    fn(iters);
+    bench_End(&sample);
+    bench_Report(name, iters, callsPerIter, &sample);
+}
+
+/* 用例 ------------------------------------------------------------------------*/
+
+static void bench_LoopOverhead(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchSink = iters;
+    }
+}
+
+/* 一个样本: 上升沿 + 下降沿两次回调 */
+static void bench_CaptureCallback(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchTim.CCR1 = 2000U + (iters & 63U);
+        benchHtim.Channel = HAL_TIM_ACTIVE_CHANNEL_1;
+        pwmCapture_Callback(&benchCap, &benchHtim);
+        benchTim.CCR2 = 600U;
+        benchHtim.Channel = HAL_TIM_ACTIVE_CHANNEL_2;
+        pwmCapture_Callback(&benchCap, &benchHtim);
+    }
+}
+
+static void bench_CaptureStatic(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchTimStatic.CCR1 = 2000U + (iters & 63U);
+        benchTimStatic.SR = TIM_FLAG_CC1;
+        benchStatic_IRQHandler();
+        benchTimStatic.CCR2 = 600U;
+        benchTimStatic.SR = TIM_FLAG_CC2;
+        benchStatic_IRQHandler();
+    }
+}
+
+static void bench_GetFreq(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchSink = pwmCapture_getFreq(benchCap);
+    }
+}
+
+static void bench_GetDuty(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchSinkF = pwmCapture_getDuty(benchCap);
+    }
+}
+
+static void bench_GetComplete(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchSink = pwmCapture_getComplete(&benchCap);
+    }
+}
+
+static void bench_PidFloat(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchSinkF = PIDController_Update(&benchPid[0], 50.0f, (float)(iters & 63U));
+    }
+}
+
+static void bench_PidQ(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchSink = (uint32_t)PIDController_Q_Update(&benchPidQ, PID_Q_FROM_FLOAT(50.0f), (pid_q_t)(iters & 63U) << PID_Q_FRAC_BITS);
+    }
+}
+
+static void bench_PidSingle(uint32_t iters)
+{
+    uint16_t i;
+
+    while (iters--)
+    {
+        for (i = 0; i < BENCH_PID_NUM; i++)
+        {
+            benchSinkF = PIDController_Update(&benchPid[i], 50.0f, (float)((iters + i) & 63U));
+        }
+    }
+}
+
+static void bench_PidBatch(uint32_t iters)
+{
+    float setpoint[BENCH_PID_NUM], measurement[BENCH_PID_NUM], out[BENCH_PID_NUM];
+    uint16_t i;
+
+    for (i = 0; i < BENCH_PID_NUM; i++)
+    {
+        setpoint[i] = 50.0f;
+    }
+    while (iters--)
+    {
+        for (i = 0; i < BENCH_PID_NUM; i++)
+        {
+            measurement[i] = (float)((iters + i) & 63U);
+        }
+        PIDBatch_Update(&benchBatch, setpoint, measurement, out);
+        benchSinkF = out[0];
+    }
+}
+
+static void bench_Setup(void)
+{
+    pwm_Capture_conf_t conf = {
+        .htim = &benchHtim,
+        .RiseChannel = TIM_CHANNEL_1,
+        .FallChannel = TIM_CHANNEL_2,
+        .tickHz = 2000000UL,
+        .mode = PWM_CAPTURE_MODE_CONTINUOUS,
+    };
+    uint16_t i;
+
+    memset(&benchTim, 0, sizeof(benchTim));
+    memset(&benchHtim, 0, sizeof(benchHtim));
+    benchHtim.Instance = &benchTim;
+    pwmCapture_InitStatic(&benchCap, &benchCapObj, &conf);
+    benchStatic_Start();
+
+    for (i = 0; i < BENCH_PID_NUM; i++)
+    {
+        PIDController_InitStatic(&benchPid[i], &benchPidObj[i], &benchPidConf);
+    }
+    PIDController_Q_Init(&benchPidQ, &benchPidConf);
+    PIDBatch_Init(&benchBatch, BENCH_PID_NUM);
+    for (i = 0; benchBatch != NULL && i < BENCH_PID_NUM; i++)
+    {
+        PIDBatch_Set(&benchBatch, i, &benchPidConf);
+    }
+}
+
+/**
+ * @brief 运行全部用例
+ * @note 主机由 bench_main.c 调用，目标板在 main() 中初始化完成后调用
+ */
+void bench_Run(void)
+{
+    bench_PlatformInit();
+    bench_Setup();
+    bench_CppSetup();
+
+    bench_Measure("loop_overhead", bench_LoopOverhead, BENCH_ITERS, 1);
+    bench_Measure("capture_callback_sample", bench_CaptureCallback, BENCH_ITERS, 1);
+    bench_Measure("capture_static_irq_sample", bench_CaptureStatic, BENCH_ITERS, 1);
+    bench_Measure("capture_cpp_callback_sample", bench_CppCaptureCallback, BENCH_ITERS, 1);
+    bench_Measure("capture_get_freq", bench_GetFreq, BENCH_ITERS, 1);
+    bench_Measure("capture_get_duty", bench_GetDuty, BENCH_ITERS, 1);
+    bench_Measure("capture_get_complete", bench_GetComplete, BENCH_ITERS, 1);
+    bench_Measure("pid_update_float", bench_PidFloat, BENCH_ITERS, 1);
+    bench_Measure("pid_update_cpp", bench_CppPidUpdate, BENCH_ITERS, 1);
+    if (benchPidQ != NULL)
+    {
+        bench_Measure("pid_update_q", bench_PidQ, BENCH_ITERS, 1);
+    }
+    bench_Measure("pid_update_single_each", bench_PidSingle, BENCH_ITERS / BENCH_PID_NUM, BENCH_PID_NUM);
+    if (benchBatch != NULL) // 目标板默认堆 0x200 不够，需加大堆
+    {
+        bench_Measure("pid_update_batch_each", bench_PidBatch, BENCH_ITERS / BENCH_PID_NUM, BENCH_PID_NUM);
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * @file bench_config.c
+ * @brief configStore 写入中掉电的恢复检查，在主机flash仿真上运行
+ * @note 先保存 n 条记录 (n 覆盖第一页写满和换页)，再用 simFlash_FailAfter() 在第 cut 个半字后停止写入，
+ *       模拟保存第 n+1 条时掉电；之后 configStore_Load() 须读出第 n 条，继续保存须成功并能跨过下一次换页
+ *       对每个 n × cut 检查一次，输出一行JSON，有失败时返回1，作为 ctest 用例运行
+ */
+#include "configStore.h"
+#include "sim_flash.h"
+#include "stdio.h"
+
+#ifndef BENCH_REV
+#define BENCH_REV "unknown"
+#endif
+
+#define CONFIG_SLOTS (CONFIG_STORE_PAGE_SIZE / sizeof(configStore_Record_t))
+#define CONFIG_HISTORY (3 * CONFIG_SLOTS) // 掉电前保存的最大记录数
+#define CONFIG_AFTER (CONFIG_SLOTS + 1)   // 恢复后继续保存的记录数，至少跨过一次换页
+
+static void config_Make(configStore_Data_t *data, uint32_t k)
+{
+    configStore_Data_t d = {
+        .capMode = PWM_CAPTURE_MODE_CONTINUOUS,
+        .capFilter = (uint8_t)(k & 0x0FU),
+        .tickHz = CAPTURE_TICK_HZ,
+        .actInMin = 0.0f,
+        .actInMax = 100.0f,
+        .kp = 1.0f,
+        .limMax = 100.0f,
+        .setpoint = (float)k,
+    };
+    *data = d;
+}
+
+/* 读出的配置是否为第 k 条 */
+static int config_Is(uint32_t k)
+{
+    configStore_Data_t data;
+
+    config_Make(&data, 0xFFFFU);
+    return configStore_Load(&data) == CONFIG_STORE_OK && data.setpoint == (float)k && data.capFilter == (k & 0x0FU);
+}
+
+int main(void)
+{
+    configStore_Data_t data;
+    uint32_t n, k, cut, cases = 0, failed = 0;
+
+    for (n = 1; n <= CONFIG_HISTORY; n++)
+    {
+        for (cut = 0; cut < sizeof(configStore_Record_t) / 2; cut++)
+        {
+            int ok = 1;
+
+            cases++;
+            simFlash_FailAfter(-1);
+            if (configStore_Erase() != CONFIG_STORE_OK) return 2;
+            for (k = 1; k <= n; k++)
+            {
+                config_Make(&data, k);
+                if (configStore_Save(&data) != CONFIG_STORE_OK) return 2;
+            }
+
+            // 第 n+1 条只写入 cut 个半字
+            simFlash_FailAfter((int32_t)cut);
+            config_Make(&data, n + 1);
+            if (configStore_Save(&data) != CONFIG_STORE_ERROR) ok = 0;
+            simFlash_FailAfter(-1);
+            if (!config_Is(n)) ok = 0;
+
+            // 重新上电后继续保存
+            for (k = n + 1; ok && k <= n + CONFIG_AFTER; k++)
+            {
+                config_Make(&data, k);
+                if (configStore_Save(&data) != CONFIG_STORE_OK || !config_Is(k)) ok = 0;
+            }
+
+            if (!ok)
+            {
+                failed++;
+                fprintf(stderr, "config_store_recovery: saved %lu, cut after %lu halfwords: failed\n",
+                        (unsigned long)n, (unsigned long)cut);
+            }
+        }
+    }
+
+    printf("{\"rev\":\"%s\",\"case\":\"config_store_recovery\",\"histories\":%lu,\"cuts\":%lu,\"cases\":%lu,\"failed\":%lu}\n",
+           BENCH_REV, (unsigned long)CONFIG_HISTORY, (unsigned long)(sizeof(configStore_Record_t) / 2),
+           (unsigned long)cases, (unsigned long)failed);
+    return failed != 0;
+}
@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "pwmCapture.hpp"
+#include "PID.hpp"
+#include <string.h>
+#include <new>
+
+/* 与 bench_cases.c 中的C用例相同的输入，比较封装的开销 */
+static TIM_TypeDef benchTimCpp;
+static TIM_HandleTypeDef benchHtimCpp;
+static PwmCapture *benchCapCpp;
+static PidController *benchPidCpp;
+
+extern "C" volatile float benchSinkF;
+
+void bench_CppSetup(void)
+{
+    pwm_Capture_conf_t conf;
+    PIDController_Conf_t pidConf;
+
+    memset(&benchTimCpp, 0, sizeof(benchTimCpp));
+    memset(&benchHtimCpp, 0, sizeof(benchHtimCpp));
+    benchHtimCpp.Instance = &benchTimCpp;
+
+    memset(&conf, 0, sizeof(conf));
+    conf.htim = &benchHtimCpp;
+    conf.RiseChannel = TIM_CHANNEL_1;
+    conf.FallChannel = TIM_CHANNEL_2;
+    conf.tickHz = 2000000UL;
+    conf.mode = PWM_CAPTURE_MODE_CONTINUOUS;
+
+    memset(&pidConf, 0, sizeof(pidConf));
+    pidConf.kp = 4.65f;
+    pidConf.ki = 0.01f;
+    pidConf.kd = 0.10f;
+    pidConf.limMin = 0.0f;
+    pidConf.limMax = 100.0f;
+    pidConf.tau = 0.02f;
+    pidConf.T = 0.0005f;
+    pidConf.limMinInt = -5.0f;
+    pidConf.limMaxInt = 10.0f;
+
+    /* 对象放在静态存储中，不依赖堆和静态构造 */
+    static unsigned char capStorage[sizeof(PwmCapture)] __attribute__((aligned(8)));
+    static unsigned char pidStorage[sizeof(PidController)] __attribute__((aligned(8)));
+    benchCapCpp = new (capStorage) PwmCapture(conf);
+    benchPidCpp = new (pidStorage) PidController(pidConf);
+}
+
+void bench_CppCaptureCallback(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchTimCpp.CCR1 = 2000U + (iters & 63U);
+        benchHtimCpp.Channel = HAL_TIM_ACTIVE_CHANNEL_1;
+        benchCapCpp->callback(&benchHtimCpp);
+        benchTimCpp.CCR2 = 600U;
+        benchHtimCpp.Channel = HAL_TIM_ACTIVE_CHANNEL_2;
+        benchCapCpp->callback(&benchHtimCpp);
+    }
+}
+
+void bench_CppPidUpdate(uint32_t iters)
+{
+    while (iters--)
+    {
+        benchSinkF = benchPidCpp->update(50.0f, (float)(iters & 63U));
+    }
+}
@@ -0,0 +1,10 @@
+#include "bench.h"
+#include "sim_tim.h"
+
+/* 主机入口: 输出JSON行到标准输出，如 ./pwmcapture_bench > bench.jsonl */
+int main(void)
+{
+    simTim_Reset();
+    bench_Run();
+    return 0;
+}
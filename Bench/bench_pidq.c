@@ -0,0 +1,84 @@
+/**
+ * @file bench_pidq.c
+ * @brief 定点PID与浮点PID的偏差检查，复现 PID.h 中记录的误差
+ * @note 两个控制器用同一个 PIDController_Conf_t，各自闭环控制一个一阶对象 (双精度仿真)，
+ *       设定值每 2500 步在 ±80 之间阶跃，共 20000 步，比较两者每一步的输出
+ *       每个场景输出一行JSON，最大偏差超过满量程的 0.005% 时返回1，作为 ctest 用例运行
+ */
+#include "PID.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "math.h"
+
+#ifndef BENCH_REV
+#define BENCH_REV "unknown"
+#endif
+
+#define PIDQ_STEPS 20000
+#define PIDQ_STEP_EVERY 2500
+#define PIDQ_TOL_FS 5e-5 // 满量程的 0.005%
+
+typedef struct
+{
+    const char *name;
+    PIDController_Conf_t conf;
+    double gain; // 对象增益
+    double tau;  // 对象时间常数 单位: 秒
+} pidq_Case_t;
+
+static const pidq_Case_t pidqCases[] = {
+    { "pi_fast", { .kp = 0.3f, .ki = 400.0f, .kd = 0.0f, .limMin = -100.0f, .limMax = 100.0f,
+                   .limMinInt = -100.0f, .limMaxInt = 100.0f, .tau = 0.001f, .T = 0.0005f }, 1.0, 0.002 },
+    { "pid_slow", { .kp = 2.0f, .ki = 20.0f, .kd = 0.01f, .limMin = -100.0f, .limMax = 100.0f,
+                    .limMinInt = -50.0f, .limMaxInt = 50.0f, .tau = 0.002f, .T = 0.0005f }, 1.0, 0.05 },
+    { "pid_gain2", { .kp = 0.8f, .ki = 60.0f, .kd = 0.002f, .limMin = -100.0f, .limMax = 100.0f,
+                     .limMinInt = -100.0f, .limMaxInt = 100.0f, .tau = 0.001f, .T = 0.0005f }, 2.0, 0.01 },
+    { "main_demo", { .kp = 4.65f, .ki = 0.01f, .kd = 0.0f, .limMin = 0.0f, .limMax = 100.0f,
+                     .limMinInt = -5.0f, .limMaxInt = 10.0f, .tau = 3.0f, .T = 0.0005f }, 1.0, 0.005 }, // Core/Src/main.c 的参数
+};
+
+int main(void)
+{
+    PIDController_Class_t objF;
+    PIDController_Handle_t pidF;
+    PIDController_Q_Handle_t pidQ;
+    PIDController_Conf_t conf;
+    double yF, yQ, a, err, errMax, fs;
+    float sp, outF, outQ;
+    unsigned i, k;
+    int fail = 0;
+
+    for (k = 0; k < sizeof(pidqCases) / sizeof(pidqCases[0]); k++)
+    {
+        conf = pidqCases[k].conf;
+        pidF = NULL;
+        pidQ = NULL;
+        PIDController_InitStatic(&pidF, &objF, &conf);
+        PIDController_Q_Init(&pidQ, &conf);
+        if (pidF == NULL || pidQ == NULL)
+        {
+            return 2;
+        }
+
+        fs = (double)conf.limMax - (double)conf.limMin;
+        a = (double)conf.T / pidqCases[k].tau;
+        yF = yQ = 0;
+        errMax = 0;
+        for (i = 0; i < PIDQ_STEPS; i++)
+        {
+            sp = ((i / PIDQ_STEP_EVERY) & 1U) ? -80.0f : 80.0f;
+            outF = PIDController_Update(&pidF, sp, (float)yF);
+            outQ = PID_Q_TO_FLOAT(PIDController_Q_Update(&pidQ, PID_Q_FROM_FLOAT(sp), PID_Q_FROM_FLOAT((float)yQ)));
+            err = fabs((double)outF - (double)outQ);
+            if (err > errMax) errMax = err;
+            yF += a * (pidqCases[k].gain * outF - yF);
+            yQ += a * (pidqCases[k].gain * outQ - yQ);
+        }
+
+        printf("{\"rev\":\"%s\",\"case\":\"%s\",\"steps\":%u,\"max_err\":%.3g,\"max_err_fs_pct\":%.5f,\"limit_fs_pct\":%.5f}\n",
+               BENCH_REV, pidqCases[k].name, PIDQ_STEPS, errMax, errMax / fs * 100.0, PIDQ_TOL_FS * 100.0);
+        if (errMax > PIDQ_TOL_FS * fs) fail = 1;
+        free(pidQ);
+    }
+    return fail;
+}
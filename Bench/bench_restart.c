@@ -0,0 +1,83 @@
+/**
+ * @file bench_restart.c
+ * @brief 捕获自动关闭或 Disarm 后用 pwmCapture_Start() 重新开启的检查，在主机仿真上运行
+ * @note 仿真定时器与HAL相同维护通道状态，自动关闭后通道仍为BUSY，直接 HAL_TIM_IC_Start_IT() 会失败
+ *       每个场景输出一行JSON，重新开启后没有新样本时返回1，作为 ctest 用例运行
+ */
+#include "sim_tim.h"
+#include "tim.h"
+#include "pwmCapture.h"
+#include "stdio.h"
+#include "string.h"
+
+#ifndef BENCH_REV
+#define BENCH_REV "unknown"
+#endif
+
+#define RESTART_PERIOD (SystemCoreClock / 1000U) // 1kHz
+#define RESTART_HIGH (RESTART_PERIOD * 3U / 10U)  // 30%
+
+static pwm_Capture_Handle_t restartCap = NULL;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    pwmCapture_Callback(&restartCap, htim);
+}
+
+/* 输入 periods 个周期，返回新增的样本数 */
+static uint32_t restart_Run(uint32_t periods)
+{
+    uint32_t seq = restartCap->seq;
+
+    while (periods--)
+    {
+        simTim_Pulse(&htim1, RESTART_HIGH, RESTART_PERIOD);
+    }
+    return restartCap->seq - seq;
+}
+
+int main(void)
+{
+    static const struct
+    {
+        const char *name;
+        uint16_t mode;
+        uint8_t disarm; // 由 pwmCapture_Disarm() 关闭，否则等待自动关闭
+    } cases[] = {
+        { "oneshot", PWM_CAPTURE_MODE_ONESHOT, 0 },
+        { "nshot4", PWM_CAPTURE_MODE_NSHOT(4), 0 },
+        { "disarm", PWM_CAPTURE_MODE_CONTINUOUS, 1 },
+    };
+    uint32_t first, stopped, again;
+    PwmCaptureState_t state;
+    unsigned k;
+    int fail = 0;
+
+    for (k = 0; k < sizeof(cases) / sizeof(cases[0]); k++)
+    {
+        simTim_Reset();
+        TIM1->PSC = CAPTURE_TIM_PSC;
+        TIM1->ARR = CAPTURE_TIM_ARR;
+        pwm_Capture_conf_t conf = {
+            .htim = &htim1,
+            .RiseChannel = TIM_CHANNEL_1,
+            .FallChannel = TIM_CHANNEL_2,
+            .tickHz = CAPTURE_TICK_HZ,
+            .mode = cases[k].mode,
+        };
+        if (pwmCapture_Init(&restartCap, &conf) != PWM_CAPTURE_OK) return 2;
+
+        first = restart_Run(10);
+        if (cases[k].disarm) pwmCapture_Disarm(&restartCap);
+        stopped = restart_Run(10);
+        state = pwmCapture_Start(&restartCap);
+        again = restart_Run(10);
+
+        printf("{\"rev\":\"%s\",\"case\":\"%s\",\"first\":%lu,\"stopped\":%lu,\"start\":%u,\"again\":%lu}\n",
+               BENCH_REV, cases[k].name, (unsigned long)first, (unsigned long)stopped, (unsigned)state, (unsigned long)again);
+        if (stopped != 0 || state != PWM_CAPTURE_OK || again == 0) fail = 1;
+        if (cases[k].mode != PWM_CAPTURE_MODE_CONTINUOUS && (first != cases[k].mode || again != cases[k].mode)) fail = 1;
+        pwmCapture_Delete(&restartCap);
+    }
+    return fail;
+}
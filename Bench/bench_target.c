@@ -0,0 +1,42 @@
+#include "bench.h"
+#include "main.h"
+#include "string.h"
+
+static uint32_t benchC0;
+
+/* DWT周期计数器，与 loopLatency 使用同一个计数器 */
+void bench_PlatformInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void bench_Begin(void)
+{
+    benchC0 = DWT->CYCCNT;
+}
+
+/* 32位计数器，72MHz 下单个用例不能超过约59秒 */
+void bench_End(bench_Sample_t *sample)
+{
+    uint32_t cycles = DWT->CYCCNT - benchC0;
+
+    memset(sample, 0, sizeof(*sample));
+    sample->cycles = cycles;
+    sample->hasCycles = 1;
+    sample->ns = (uint64_t)cycles * 1000U / (SystemCoreClock / 1000000U);
+}
+
+/* ITM 端口0 (SWO)，调试器未开启时不输出 */
+void bench_Write(const char *line)
+{
+    while (*line)
+    {
+        ITM_SendChar((uint32_t)*line++);
+    }
+}
+
+const char *bench_Platform(void)
+{
+    return "stm32f103";
+}
@@ -0,0 +1,37 @@
+/**
+ * @file size_c.c
+ * @brief 代码体积对比: C接口，与 size_cpp.cpp 做同样的事
+ * @note 初始化一个捕获实例和一个PID，中断中更新捕获，取频率和占空比作为PID输入
+ */
+#include "pwmCapture.h"
+#include "PID.h"
+
+static pwm_Capture_Class_t sizeCapObj;
+static pwm_Capture_Handle_t sizeCap = NULL;
+static PIDController_Class_t sizePidObj;
+static PIDController_Handle_t sizePid = NULL;
+
+void size_Init(pwm_Capture_conf_t *conf, PIDController_Conf_t *pidConf)
+{
+    pwmCapture_InitStatic(&sizeCap, &sizeCapObj, conf);
+    PIDController_InitStatic(&sizePid, &sizePidObj, pidConf);
+}
+
+void size_Callback(TIM_HandleTypeDef *htim)
+{
+    pwmCapture_Callback(&sizeCap, htim);
+}
+
+float size_Step(float setpoint)
+{
+    if (!pwmCapture_getComplete(&sizeCap))
+    {
+        return sizePidObj.out;
+    }
+    return PIDController_Update(&sizePid, setpoint, pwmCapture_getDuty(sizeCap));
+}
+
+uint32_t size_Freq(void)
+{
+    return pwmCapture_getFreq(sizeCap);
+}
@@ -0,0 +1,38 @@
+/**
+ * @file size_cpp.cpp
+ * @brief 代码体积对比: C++封装，与 size_c.c 做同样的事
+ * @note 对象放在静态存储中用 placement new 构造，与 bench_cpp.cpp 相同，不引入静态构造和堆
+ */
+#include "pwmCapture.hpp"
+#include "PID.hpp"
+#include <new>
+
+static unsigned char sizeCapStorage[sizeof(PwmCapture)] __attribute__((aligned(8)));
+static unsigned char sizePidStorage[sizeof(PidController)] __attribute__((aligned(8)));
+static PwmCapture *sizeCap;
+static PidController *sizePid;
+
+extern "C" void size_Init(pwm_Capture_conf_t *conf, PIDController_Conf_t *pidConf)
+{
+    sizeCap = new (sizeCapStorage) PwmCapture(*conf);
+    sizePid = new (sizePidStorage) PidController(*pidConf);
+}
+
+extern "C" void size_Callback(TIM_HandleTypeDef *htim)
+{
+    sizeCap->callback(htim);
+}
+
+extern "C" float size_Step(float setpoint)
+{
+    if (!sizeCap->complete())
+    {
+        return sizePid->output();
+    }
+    return sizePid->update(setpoint, sizeCap->duty());
+}
+
+extern "C" uint32_t size_Freq(void)
+{
+    return sizeCap->freq();
+}
@@ -0,0 +1,19 @@
+/**
+ * @file size_pid_f.c
+ * @brief 代码体积对比: 浮点PID，与 size_pid_q.c 做同样的事
+ * @note 目标板没有FPU，浮点运算调用 libgcc 的 __aeabi_fxxx，体积报告中列出这些未定义符号
+ */
+#include "PID.h"
+#include "stddef.h"
+
+static PIDController_Handle_t sizePidF = NULL;
+
+void size_PidInit(PIDController_Conf_t *conf)
+{
+    PIDController_Init(&sizePidF, conf);
+}
+
+float size_PidStep(float setpoint, float measurement)
+{
+    return PIDController_Update(&sizePidF, setpoint, measurement);
+}
@@ -0,0 +1,19 @@
+/**
+ * @file size_pid_q.c
+ * @brief 代码体积对比: 定点PID，与 size_pid_f.c 做同样的事
+ * @note 输入输出直接用 pid_q_t，调用处不做浮点换算
+ */
+#include "PID.h"
+#include "stddef.h"
+
+static PIDController_Q_Handle_t sizePidQ = NULL;
+
+void size_PidInit(PIDController_Conf_t *conf)
+{
+    PIDController_Q_Init(&sizePidQ, conf);
+}
+
+pid_q_t size_PidStep(pid_q_t setpoint, pid_q_t measurement)
+{
+    return PIDController_Q_Update(&sizePidQ, setpoint, measurement);
+}
@@ -31,7 +31,7 @@ extern "C" {
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "pwmCapture_timing.h"
 /* USER CODE END Includes */
 
 /* Exported types ------------------------------------------------------------*/
@@ -59,6 +59,31 @@ void Error_Handler(void);
 /* Private defines -----------------------------------------------------------*/
 
 /* USER CODE BEGIN Private defines */
+/* 捕获定时器 TIM1 的求解参数 */
+#define CAPTURE_TIM_CLK_HZ  72000000UL // APB2 定时器时钟
+#define CAPTURE_FREQ_MIN_HZ 50UL
+#define CAPTURE_FREQ_MAX_HZ 2000UL
+#define CAPTURE_RESOLUTION  1000UL     // 最高频率下一个周期的最少计数值
+
+#define CAPTURE_TIM_PSC     PWM_CAPTURE_CALC_PSC(CAPTURE_TIM_CLK_HZ, CAPTURE_FREQ_MAX_HZ, CAPTURE_RESOLUTION)
+#define CAPTURE_TIM_ARR     PWM_CAPTURE_CALC_ARR(CAPTURE_TIM_CLK_HZ, CAPTURE_FREQ_MIN_HZ, CAPTURE_FREQ_MAX_HZ, CAPTURE_RESOLUTION)
+#define CAPTURE_TICK_HZ     PWM_CAPTURE_CALC_TICK_HZ(CAPTURE_TIM_CLK_HZ, CAPTURE_FREQ_MAX_HZ, CAPTURE_RESOLUTION)
+
+/* 捕获中断记录边沿的DWT时刻，示例用 loopLatency 统计闭环延迟 */
+#define PWM_CAPTURE_TIMESTAMP 1
+
+/* PID运行方式: 0 每个新的捕获样本运行一次 (pidLink)，1 在 SysTick 中按固定周期运行 (pidScheduler) */
+#define PID_USE_SCHEDULER     0
+#define PID_SCHEDULER_PERIOD  50U      // 调度周期 单位: 节拍 (1ms)
+
+/* USART1 协议: 0 遥测 + 串口命令，1 Modbus RTU 从机 */
+#define USART1_MODBUS       0
+#define MODBUS_ADDRESS      1U         // Modbus 从机地址
+
+/* 配置持久化: 为1时flash中没有有效配置 (第一次上电或格式版本变化) 先自整定PID，结果与默认配置一起保存
+ * 自整定会让执行器在 outLow/outHigh 之间切换，接入实际负载前确认允许后再打开 */
+#define CONFIG_AUTOTUNE_ON_FIRST_BOOT 0
+#define CONFIG_AUTOTUNE_TIMEOUT_MS 30000U // 自整定超时，超时不保存，下次上电重新整定
 
 /* USER CODE END Private defines */
 
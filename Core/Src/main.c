@@ -18,6 +18,7 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "dma.h"
 #include "tim.h"
 #include "usart.h"
 #include "gpio.h"
@@ -26,6 +27,15 @@
 /* USER CODE BEGIN Includes */
 #include "pwmCapture.h"
 #include "PID.h"
+#include "pidLink.h"
+#include "pidScheduler.h"
+#include "pwmActuator.h"
+#include "loopLatency.h"
+#include "telemetry.h"
+#include "cmdChannel.h"
+#include "modbusRtu.h"
+#include "PIDAutotune.h"
+#include "configStore.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -48,20 +58,88 @@
 /* USER CODE BEGIN PV */
 pwm_Capture_Handle_t pwm_Capture = NULL;
 PIDController_Handle_t pidHandle = NULL;
+pidLink_Handle_t pidLink = NULL;
+pwmActuator_Handle_t pwmActuator = NULL;
+loopLatency_Handle_t loopLatency = NULL;
+telemetry_Handle_t telemetry = NULL;
+cmdChannel_Handle_t cmdChannel = NULL;
+modbusRtu_Handle_t modbus = NULL;
+#if USART1_MODBUS
+static modbusRtu_Class_t modbusObj;
+#else
+static uint8_t telemetryBuf[512];
+uint32_t telemetryTick = 0;
+static uint8_t cmdRxBuf[64];
+#endif
 uint8_t flag = 0;
-float pidOut = 0;
-float pidInput = 0;
-float pidSetPoint = 0;
+volatile float pidOut = 0;
+volatile float pidInput = 0;
+volatile float pidSetPoint = 50; // 目标占空比 单位: %
+// flash中没有有效配置时使用的默认值
+configStore_Data_t config = {
+ .capMode = PWM_CAPTURE_MODE_CONTINUOUS,
+ .capFilter = 0,
+ .tickHz = CAPTURE_TICK_HZ,
+ .actInMin = 0,
+ .actInMax = 100,
+ .kp = 4.65f,
+ .ki = 0.01f,
+ .kd = 0.00f,
+ .limMin = 0,
+ .limMax = 100.00f,
+ .limMinInt = -5.00f,
+ .limMaxInt = 10,
+ .tau = 3,
+ .setpoint = 50,
+};
+ConfigStoreState_t configState = CONFIG_STORE_EMPTY;
+// 命令通道或 Modbus 置位，主循环中保存当前配置
+volatile bool configSaveRequest = false;
+bool pidLoopRunning = false; // 闭环已接入，自整定期间为false
+#if CONFIG_AUTOTUNE_ON_FIRST_BOOT
+PIDAutotune_Handle_t autotune = NULL; // 第一次上电的自整定，结束后为NULL
+uint32_t autotuneTick = 0;
+#endif
+configStore_Source_t configSource = {
+ .cap = &pwm_Capture,
+ .actuator = &pwmActuator,
+ .pid = &pidHandle,
+ .setpoint = &pidSetPoint,
+};
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
+static void pidLoop_Start(void);
 
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+/**
+  * @brief 接入闭环，自整定期间不调用，两者都会写执行器
+  */
+static void pidLoop_Start(void)
+{
+#if PID_USE_SCHEDULER
+ // 在 SysTick 中每 PID_SCHEDULER_PERIOD 个节拍运行一次，测量值和执行器输出在主循环中更新
+ pidScheduler_Register(&pidHandle,&pidSetPoint,&pidInput,&pidOut,PID_SCHEDULER_PERIOD);
+#else
+ // 每个新的捕获样本更新一次控制器，在 HAL_TIM_IC_CaptureCallback() 中运行
+ pidLink_conf_t link_conf = {
+  .cap = &pwm_Capture,
+  .pid = &pidHandle,
+  .setpoint = &pidSetPoint,
+  .output = &pidOut,
+  .actuator = &pwmActuator,
+  .latency = &loopLatency,
+  .input = PID_LINK_INPUT_DUTY,
+ };
+ pidLink_Init(&pidLink,&link_conf);
+#endif
+ pidLoopRunning = true;
+}
 
 /* USER CODE END 0 */
 
@@ -94,29 +172,118 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_TIM1_Init();
   MX_TIM3_Init();
   MX_USART1_UART_Init();
   /* USER CODE BEGIN 2 */
+ // 读出上次保存的捕获模式、标度修正和PID增益，没有则使用默认值
+ configState = configStore_Load(&config);
+ pidSetPoint = config.setpoint;
  HAL_TIM_PWM_Start(&htim3,TIM_CHANNEL_1);
+ // PID输出 actInMin~actInMax 映射为TIM3 CH1的占空比
+ pwmActuator_conf_t act_conf = {
+	 .htim = &htim3,
+	 .Channel = TIM_CHANNEL_1,
+	 .inMin = config.actInMin,
+	 .inMax = config.actInMax,
+ };
+ pwmActuator_Init(&pwmActuator,&act_conf);
  pwm_Capture_conf_t conf = {
 	 .htim = &htim1,
 	 .RiseChannel = TIM_CHANNEL_1,
 	 .FallChannel = TIM_CHANNEL_2,
+	 .tickHz = config.tickHz,
+	 .mode = config.capMode,
  };
  pwmCapture_Init(&pwm_Capture,&conf);
+ pwmCapture_SetFilter(&pwm_Capture,config.capFilter);
  PIDController_Conf_t pid_conf = {
-  .kp = 4.65,
-  .ki = 0.01,
-  .kd = 0.00,
-  .limMax = 100.00,
-  .limMin = 0,
-  .limMaxInt = 10,
-  .limMinInt = -5.00,
-  .tau = 3,
-  .T = 50,
+  .kp = config.kp,
+  .ki = config.ki,
+  .kd = config.kd,
+  .limMax = config.limMax,
+  .limMin = config.limMin,
+  .limMaxInt = config.limMaxInt,
+  .limMinInt = config.limMinInt,
+  .tau = config.tau,
+  .T = 0.0005f, // 由捕获时间戳重新设置
  };
  PIDController_Init(&pidHandle,&pid_conf);
+ loopLatency_conf_t lat_conf = {
+  .binWidth = 72,
+ };
+ loopLatency_Init(&loopLatency,&lat_conf);
+ if(configState != CONFIG_STORE_OK)
+ {
+#if CONFIG_AUTOTUNE_ON_FIRST_BOOT
+  // 第一次上电: 继电反馈整定增益，在主循环中逐样本运行，结束后才接入闭环
+  // 整定成功才保存，失败或超时 (如输入未接) 时不保存，下次上电重新整定
+  PIDAutotune_Conf_t at_conf = {
+   .cap = &pwm_Capture,
+   .actuator = &pwmActuator,
+   .pid = &pidHandle,
+   .input = PID_LINK_INPUT_DUTY,
+   .rule = PID_AUTOTUNE_RULE_TL,
+   .setpoint = config.setpoint,
+   .hysteresis = 1.0f,
+   .outHigh = 70.0f,
+   .outLow = 30.0f,
+   .cycles = 4,
+   .maxSamples = 20000,
+  };
+  PIDAutotune_Init(&autotune,&at_conf);
+  PIDAutotune_Start(&autotune);
+  autotuneTick = HAL_GetTick();
+#else
+  // 擦除一页约20ms，在控制回路运行前完成
+  configState = configStore_Save(&config);
+#endif
+ }
+#if CONFIG_AUTOTUNE_ON_FIRST_BOOT
+ if(autotune == NULL)
+ {
+  pidLoop_Start();
+ }
+#else
+ pidLoop_Start();
+#endif
+#if USART1_MODBUS
+ // PLC经 RS-485 轮询捕获结果、PID状态和统计，修改PID参数和捕获配置
+ // 收发器为自动方向切换时 dePort 为NULL，否则填入发送使能引脚
+ modbusRtu_conf_t mb_conf = {
+  .huart = &huart1,
+  .address = MODBUS_ADDRESS,
+  .dePort = NULL,
+  .cap = &pwm_Capture,
+  .pid = &pidHandle,
+  .setpoint = &pidSetPoint,
+  .link = &pidLink,
+  .latency = &loopLatency,
+  .saveRequest = &configSaveRequest,
+ };
+ modbusRtu_InitStatic(&modbus,&modbusObj,&mb_conf);
+#else
+ // 每个捕获样本进入批量差分帧，另外每100ms发送一个 捕获样本 + PID状态 帧
+ telemetry_conf_t tel_conf = {
+  .huart = &huart1,
+  .buf = telemetryBuf,
+  .size = sizeof(telemetryBuf),
+ };
+ telemetry_Init(&telemetry,&tel_conf);
+ // USART1 收到的命令在两次捕获之间修改捕获模式、滤波、PID增益和设定值，应答经遥测发送
+ cmdChannel_conf_t cmd_conf = {
+  .huart = &huart1,
+  .rxBuf = cmdRxBuf,
+  .rxSize = sizeof(cmdRxBuf),
+  .cap = &pwm_Capture,
+  .pid = &pidHandle,
+  .setpoint = &pidSetPoint,
+  .telemetry = &telemetry,
+  .saveRequest = &configSaveRequest,
+ };
+ cmdChannel_Init(&cmdChannel,&cmd_conf);
+#endif
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -124,11 +291,45 @@ int main(void)
   while (1)
   {
      __NOP();
-	  pidOut = PIDController_Update(&pidHandle,pidSetPoint,pidInput);
 	  if(pwmCapture_getComplete(&pwm_Capture) == true)
 	  {
 	   pidInput = pwmCapture_getDuty(pwm_Capture);
-	   pwmCapture_Stop(&pwm_Capture);
+	  }
+#if CONFIG_AUTOTUNE_ON_FIRST_BOOT
+	  if(autotune != NULL)
+	  {
+	   // 没有新样本时立即返回；输入未接时样本数不增加，由超时结束
+	   PIDAutotune_State_t st = PIDAutotune_Step(&autotune);
+	   if(st != PID_AUTOTUNE_RUNNING || HAL_GetTick() - autotuneTick >= CONFIG_AUTOTUNE_TIMEOUT_MS)
+	   {
+	    if(st == PID_AUTOTUNE_DONE)
+	    {
+	     configSaveRequest = true; // 整定结果已写入 pidHandle，下面与保存命令一样保存
+	    }
+	    PIDAutotune_Delete(&autotune); // 超时时恢复执行器输出
+	    pidLoop_Start();
+	   }
+	  }
+#endif
+#if PID_USE_SCHEDULER
+	  if(pidLoopRunning)
+	  {
+	   pwmActuator_Write(&pwmActuator,pidOut);
+	  }
+#endif
+#if !USART1_MODBUS
+	  if(HAL_GetTick() - telemetryTick >= 100)
+	  {
+	   telemetryTick = HAL_GetTick();
+	   telemetry_PushSample(&telemetry,&pwm_Capture,&pidHandle);
+	  }
+#endif
+	  if(configSaveRequest)
+	  {
+	   // 擦写期间中断延迟约20ms，捕获边沿由硬件锁存
+	   configStore_Snapshot(&config,&configSource);
+	   configState = configStore_Save(&config);
+	   configSaveRequest = false;
 	  }
 
     /* USER CODE END WHILE */
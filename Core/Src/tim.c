@@ -22,8 +22,14 @@
 
 /* USER CODE BEGIN 0 */
 #include "pwmCapture.h"
+#include "pidLink.h"
+#include "telemetry.h"
 
 extern pwm_Capture_Handle_t pwm_Capture;
+extern pidLink_Handle_t pidLink;
+extern telemetry_Handle_t telemetry;
+
+PWM_CAPTURE_TIMING_CHECK(CAPTURE_TIM_CLK_HZ, CAPTURE_FREQ_MIN_HZ, CAPTURE_FREQ_MAX_HZ, CAPTURE_RESOLUTION);
 /* USER CODE END 0 */
 
 TIM_HandleTypeDef htim1;
@@ -94,7 +100,13 @@ void MX_TIM1_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM1_Init 2 */
-
+  /* 分频和重装载值使用编译期求解的结果 */
+  htim1.Init.Prescaler = CAPTURE_TIM_PSC;
+  htim1.Init.Period = CAPTURE_TIM_ARR;
+  __HAL_TIM_SET_PRESCALER(&htim1, CAPTURE_TIM_PSC);
+  __HAL_TIM_SET_AUTORELOAD(&htim1, CAPTURE_TIM_ARR);
+  htim1.Instance->EGR = TIM_EGR_UG;
+  __HAL_TIM_CLEAR_FLAG(&htim1, TIM_FLAG_UPDATE);
   /* USER CODE END TIM1_Init 2 */
 
 }
@@ -265,6 +277,10 @@ void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
   if(htim->Instance == TIM1)
   {
     pwmCapture_Callback(&pwm_Capture,htim);
+    pidLink_Step(&pidLink);
+#if !USART1_MODBUS
+    telemetry_PushDelta(&telemetry,&pwm_Capture);
+#endif
   }
 }
 /* USER CODE END 1 */
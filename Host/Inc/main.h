@@ -0,0 +1,313 @@
+/**
+ * @file main.h
+ * @brief 主机仿真用的 main.h，代替 Core/Inc/main.h
+ * @note 只提供 MDK-ARM 下各模块用到的HAL子集: TIM寄存器与句柄、相关宏、
+ *       DWT/CoreDebug/SCB、PRIMASK、SystemCoreClock、HAL_GetTick、UART句柄与DMA收发、GPIO输出
+ *       寄存器布局与 stm32f103xb.h 相同，常量与 stm32f1xx_hal_tim.h 相同
+ *       TIM1/TIM3 指向 sim_tim.c 中的仿真寄存器，行为见 sim_tim.h
+ *       USART1 的DMA收发由 sim_uart.c 接到文件描述符上，行为见 sim_uart.h，GPIO只记录输出寄存器
+ */
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include "stdint.h"
+#include "stddef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO volatile
+
+/* 外设寄存器 ----------------------------------------------------------------*/
+typedef struct
+{
+  __IO uint32_t CR1;
+  __IO uint32_t CR2;
+  __IO uint32_t SMCR;
+  __IO uint32_t DIER;
+  __IO uint32_t SR;
+  __IO uint32_t EGR;
+  __IO uint32_t CCMR1;
+  __IO uint32_t CCMR2;
+  __IO uint32_t CCER;
+  __IO uint32_t CNT;
+  __IO uint32_t PSC;
+  __IO uint32_t ARR;
+  __IO uint32_t RCR;
+  __IO uint32_t CCR1;
+  __IO uint32_t CCR2;
+  __IO uint32_t CCR3;
+  __IO uint32_t CCR4;
+  __IO uint32_t BDTR;
+  __IO uint32_t DCR;
+  __IO uint32_t DMAR;
+  __IO uint32_t OR;
+} TIM_TypeDef;
+
+typedef struct
+{
+  __IO uint32_t SR;
+  __IO uint32_t DR;
+  __IO uint32_t BRR;
+  __IO uint32_t CR1;
+  __IO uint32_t CR2;
+  __IO uint32_t CR3;
+  __IO uint32_t GTPR;
+} USART_TypeDef;
+
+typedef struct
+{
+  __IO uint32_t CRL;
+  __IO uint32_t CRH;
+  __IO uint32_t IDR;
+  __IO uint32_t ODR;
+  __IO uint32_t BSRR;
+  __IO uint32_t BRR;
+  __IO uint32_t LCKR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+  __IO uint32_t DHCSR;
+  __IO uint32_t DCRSR;
+  __IO uint32_t DCRDR;
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+  __IO uint32_t CPUID;
+  __IO uint32_t ICSR;
+} SCB_Type;
+
+extern TIM_TypeDef simTIM1;
+extern TIM_TypeDef simTIM3;
+extern USART_TypeDef simUSART1;
+extern GPIO_TypeDef simGPIOA;
+extern DWT_Type simDWT;
+extern CoreDebug_Type simCoreDebug;
+extern SCB_Type simSCB;
+
+#define TIM1      (&simTIM1)
+#define TIM3      (&simTIM3)
+#define USART1    (&simUSART1)
+#define GPIOA     (&simGPIOA)
+#define DWT       (&simDWT)
+#define CoreDebug (&simCoreDebug)
+#define SCB       (&simSCB)
+
+#define TIM_CR1_CEN                 0x00000001U
+#define TIM_DIER_CC1IE              0x00000002U
+#define TIM_DIER_CC2IE              0x00000004U
+#define TIM_DIER_CC3IE              0x00000008U
+#define TIM_DIER_CC4IE              0x00000010U
+#define TIM_SR_UIF                  0x00000001U
+#define TIM_SR_CC1IF                0x00000002U
+#define TIM_SR_CC2IF                0x00000004U
+#define TIM_SR_CC3IF                0x00000008U
+#define TIM_SR_CC4IF                0x00000010U
+#define TIM_SR_CC1OF                0x00000200U
+#define TIM_EGR_UG                  0x00000001U
+#define TIM_CCMR1_OC1PE             0x00000008U
+#define TIM_CCMR1_OC2PE             0x00000800U
+#define TIM_CCMR2_OC3PE             0x00000008U
+#define TIM_CCMR2_OC4PE             0x00000800U
+#define TIM_CCER_CC1E               0x00000001U
+#define TIM_CCER_CC2E               0x00000010U
+#define TIM_CCER_CC3E               0x00000100U
+#define TIM_CCER_CC4E               0x00001000U
+#define TIM_BDTR_MOE                0x00008000U
+
+#define DWT_CTRL_CYCCNTENA_Msk      0x00000001U
+#define CoreDebug_DEMCR_TRCENA_Msk  0x01000000U
+#define SCB_ICSR_PENDSTSET_Msk      0x04000000U
+
+/* HAL -----------------------------------------------------------------------*/
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+  HAL_TIM_ACTIVE_CHANNEL_1        = 0x01U,
+  HAL_TIM_ACTIVE_CHANNEL_2        = 0x02U,
+  HAL_TIM_ACTIVE_CHANNEL_3        = 0x04U,
+  HAL_TIM_ACTIVE_CHANNEL_4        = 0x08U,
+  HAL_TIM_ACTIVE_CHANNEL_CLEARED  = 0x00U
+} HAL_TIM_ActiveChannel;
+
+typedef enum
+{
+  HAL_TIM_CHANNEL_STATE_RESET             = 0x00U,
+  HAL_TIM_CHANNEL_STATE_READY             = 0x01U,
+  HAL_TIM_CHANNEL_STATE_BUSY              = 0x02U,
+} HAL_TIM_ChannelStateTypeDef;
+
+typedef struct __TIM_HandleTypeDef
+{
+  TIM_TypeDef           *Instance;
+  HAL_TIM_ActiveChannel Channel;
+  __IO HAL_TIM_ChannelStateTypeDef ChannelState[4]; // 与HAL相同: Start_IT 置为BUSY，Stop_IT 恢复
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1   0x00000000U
+#define TIM_CHANNEL_2   0x00000004U
+#define TIM_CHANNEL_3   0x00000008U
+#define TIM_CHANNEL_4   0x0000000CU
+#define TIM_CHANNEL_ALL 0x0000003CU
+
+#define TIM_IT_UPDATE   TIM_SR_UIF
+#define TIM_IT_CC1      TIM_DIER_CC1IE
+#define TIM_IT_CC2      TIM_DIER_CC2IE
+#define TIM_IT_CC3      TIM_DIER_CC3IE
+#define TIM_IT_CC4      TIM_DIER_CC4IE
+
+#define TIM_FLAG_UPDATE TIM_SR_UIF
+#define TIM_FLAG_CC1    TIM_SR_CC1IF
+#define TIM_FLAG_CC2    TIM_SR_CC2IF
+#define TIM_FLAG_CC3    TIM_SR_CC3IF
+#define TIM_FLAG_CC4    TIM_SR_CC4IF
+
+/* SR 为写0清除，仿真中由函数维护，直接写 SR 的代码在一次中断内只能写一次 */
+#define __HAL_TIM_CLEAR_FLAG(__HANDLE__, __FLAG__)        simTim_ClearFlag((__HANDLE__)->Instance, (__FLAG__))
+#define __HAL_TIM_GET_COUNTER(__HANDLE__)                 ((__HANDLE__)->Instance->CNT)
+#define __HAL_TIM_GET_AUTORELOAD(__HANDLE__)              ((__HANDLE__)->Instance->ARR)
+
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__) \
+  (((__CHANNEL__) == TIM_CHANNEL_1) ? ((__HANDLE__)->Instance->CCR1) :\
+   ((__CHANNEL__) == TIM_CHANNEL_2) ? ((__HANDLE__)->Instance->CCR2) :\
+   ((__CHANNEL__) == TIM_CHANNEL_3) ? ((__HANDLE__)->Instance->CCR3) :\
+   ((__HANDLE__)->Instance->CCR4))
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+  (*(&(__HANDLE__)->Instance->CCR1 + ((__CHANNEL__) >> 2U)) = (__COMPARE__))
+
+#define __HAL_TIM_ENABLE_OCxPRELOAD(__HANDLE__, __CHANNEL__)    \
+  (((__CHANNEL__) == TIM_CHANNEL_1) ? ((__HANDLE__)->Instance->CCMR1 |= TIM_CCMR1_OC1PE) :\
+   ((__CHANNEL__) == TIM_CHANNEL_2) ? ((__HANDLE__)->Instance->CCMR1 |= TIM_CCMR1_OC2PE) :\
+   ((__CHANNEL__) == TIM_CHANNEL_3) ? ((__HANDLE__)->Instance->CCMR2 |= TIM_CCMR2_OC3PE) :\
+   ((__HANDLE__)->Instance->CCMR2 |= TIM_CCMR2_OC4PE))
+
+void simTim_ClearFlag(TIM_TypeDef *tim, uint32_t flag);
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim);
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim);
+uint32_t HAL_GetTick(void);
+
+typedef struct
+{
+  uint32_t BaudRate;
+} UART_InitTypeDef;
+
+#define HAL_UART_STATE_READY   0x20U
+#define HAL_UART_STATE_BUSY_TX 0x21U
+#define HAL_UART_STATE_BUSY_RX 0x22U
+
+#define HAL_UART_RXEVENT_TC    0x00U
+#define HAL_UART_RXEVENT_HT    0x01U
+#define HAL_UART_RXEVENT_IDLE  0x02U
+
+typedef uint32_t HAL_UART_RxEventTypeTypeDef;
+
+typedef struct __UART_HandleTypeDef
+{
+  USART_TypeDef    *Instance;
+  UART_InitTypeDef Init;
+  uint8_t          *pRxBuffPtr;
+  uint16_t         RxXferSize;
+  __IO uint32_t    gState;
+  __IO uint32_t    RxState;
+  __IO HAL_UART_RxEventTypeTypeDef RxEventType;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart);
+HAL_UART_RxEventTypeTypeDef HAL_UARTEx_GetRxEventType(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+typedef enum
+{
+  GPIO_PIN_RESET = 0U,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+/* FLASH: 仿真最后两页，内容在 sim_flash.c 的 simFlash 中 -----------------------*/
+#define FLASH_PAGE_SIZE            0x400U
+#define FLASH_BANK_1               1U
+#define FLASH_TYPEERASE_PAGES      0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define FLASH_TYPEPROGRAM_WORD     0x02U
+
+#define SIM_FLASH_BASE 0x0800F800UL
+#define SIM_FLASH_SIZE (2U * FLASH_PAGE_SIZE)
+
+typedef struct
+{
+  uint32_t TypeErase;
+  uint32_t Banks;
+  uint32_t PageAddress;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+extern uint8_t simFlash[SIM_FLASH_SIZE];
+
+#define CONFIG_STORE_MEM(addr) ((const uint8_t *)&simFlash[(addr) - SIM_FLASH_BASE])
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+
+/* 内核 ----------------------------------------------------------------------*/
+extern uint32_t SystemCoreClock;
+extern uint32_t simPrimask;
+
+static inline uint32_t __get_PRIMASK(void) { return simPrimask; }
+static inline void __set_PRIMASK(uint32_t priMask) { simPrimask = priMask; }
+static inline void __disable_irq(void) { simPrimask = 1U; }
+static inline void __enable_irq(void) { simPrimask = 0U; }
+static inline void __DMB(void) { __sync_synchronize(); }
+
+void Error_Handler(void);
+
+/* 与 Core/Inc/main.h 相同的捕获参数 ------------------------------------------*/
+#include "pwmCapture_timing.h"
+
+#define CAPTURE_TIM_CLK_HZ  72000000UL // APB2 定时器时钟
+#define CAPTURE_FREQ_MIN_HZ 50UL
+#define CAPTURE_FREQ_MAX_HZ 2000UL
+#define CAPTURE_RESOLUTION  1000UL     // 最高频率下一个周期的最少计数值
+
+#define CAPTURE_TIM_PSC     PWM_CAPTURE_CALC_PSC(CAPTURE_TIM_CLK_HZ, CAPTURE_FREQ_MAX_HZ, CAPTURE_RESOLUTION)
+#define CAPTURE_TIM_ARR     PWM_CAPTURE_CALC_ARR(CAPTURE_TIM_CLK_HZ, CAPTURE_FREQ_MIN_HZ, CAPTURE_FREQ_MAX_HZ, CAPTURE_RESOLUTION)
+#define CAPTURE_TICK_HZ     PWM_CAPTURE_CALC_TICK_HZ(CAPTURE_TIM_CLK_HZ, CAPTURE_FREQ_MAX_HZ, CAPTURE_RESOLUTION)
+
+#define PWM_CAPTURE_TIMESTAMP 1 // 与 Core/Inc/main.h 相同，仿真中统计闭环延迟
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
@@ -0,0 +1,25 @@
+#ifndef SIM_FLASH_H
+#define SIM_FLASH_H
+
+/**
+ * @file sim_flash.h
+ * @brief 主机上的flash仿真，只有最后两页 (SIM_FLASH_BASE 起 SIM_FLASH_SIZE 字节)，供 configStore 使用
+ * @note 与 F1 相同: 按页擦除为 0xFF，按半字写入，写入的半字不是 0xFFFF 且数据不为0时失败
+ *       未锁定时写入和擦除失败。simFlash_Attach() 后每次修改都写回文件，相当于断电后内容保留
+ *       simFlash_FailAfter() 在第 n 个半字后停止写入，用于模拟写入中掉电
+ */
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int simFlash_Attach(const char *path);
+void simFlash_FailAfter(int32_t halfwords);
+uint32_t simFlash_Erases(uint32_t page);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !SIM_FLASH_H
@@ -0,0 +1,34 @@
+#ifndef SIM_TIM_H
+#define SIM_TIM_H
+
+/**
+ * @file sim_tim.h
+ * @brief 主机上的定时器输入捕获仿真
+ * @note 仿真时间以CPU周期计 (SystemCoreClock)，计数器频率 = SystemCoreClock / (PSC + 1)，到 ARR 后回绕
+ *       输入按 tim.c 中 TIM1 的配置: CH1 直接捕获上升沿，CH2 间接捕获下降沿，上升沿复位计数器(从模式复位)
+ *       捕获时标志已置位则置溢出捕获标志 CCxOF，通道未使能(CCER)或计数器未开启(CR1.CEN)时不捕获
+ *       DIER 中对应中断已使能时调用该定时器的中断函数，默认为 HAL_TIM_IRQHandler()
+ *       HAL_TIM_IC_Start_IT / Stop_IT 与HAL相同维护通道状态，通道已开启 (BUSY) 时 Start_IT 返回错误
+ *       DWT->CYCCNT 在开启后跟随仿真时间，中断中读取的 CNT、CYCCNT 包含设定的中断延迟
+ */
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*simTim_IRQ_t)(void);
+
+void simTim_Reset(void);
+void simTim_SetIRQ(TIM_HandleTypeDef *htim, simTim_IRQ_t irq);
+void simTim_SetLatency(uint32_t cycles);
+void simTim_Edge(TIM_HandleTypeDef *htim, uint8_t rising, uint64_t cycle);
+void simTim_Pulse(TIM_HandleTypeDef *htim, uint64_t high, uint64_t period);
+void simTim_Loopback(TIM_HandleTypeDef *in, TIM_HandleTypeDef *out, uint32_t channel, uint32_t periods);
+uint64_t simTim_Now(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !SIM_TIM_H
@@ -0,0 +1,28 @@
+#ifndef SIM_UART_H
+#define SIM_UART_H
+
+/**
+ * @file sim_uart.h
+ * @brief 主机上的串口DMA收发仿真，把 huart 接到一个文件描述符 (pty、管道、套接字)
+ * @note 发送: HAL_UART_Transmit_DMA() 记下数据，按 Init.BaudRate (10位每字节) 在仿真时间上计算完成时刻，
+ *       simUart_Poll() 发现时刻已到时写入描述符并调用 HAL_UART_TxCpltCallback()，波特率为0时下一次 Poll 即完成
+ *       描述符写不进去 (对端没有读) 时丢弃，与没有接收方的串口线相同
+ *       接收: HAL_UARTEx_ReceiveToIdle_DMA() 按循环DMA处理，simUart_Poll() 读出描述符中的全部数据写入接收缓冲区，
+ *       与HAL相同在半满、全满时调用 HAL_UARTEx_RxEventCallback()，一次读取结束视为空闲线，再调用一次
+ *       回调在 simUart_Poll() 中同步调用，相当于串口和DMA中断
+ */
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void simUart_Attach(UART_HandleTypeDef *huart, int fd);
+void simUart_Poll(UART_HandleTypeDef *huart);
+uint32_t simUart_Dropped(UART_HandleTypeDef *huart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !SIM_UART_H
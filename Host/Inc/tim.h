@@ -0,0 +1,22 @@
+/**
+ * @file tim.h
+ * @brief 主机仿真用的 tim.h，代替 Core/Inc/tim.h
+ */
+#ifndef __TIM_H__
+#define __TIM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+extern TIM_HandleTypeDef htim1;
+
+extern TIM_HandleTypeDef htim3;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIM_H__ */
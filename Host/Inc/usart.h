@@ -0,0 +1,20 @@
+/**
+ * @file usart.h
+ * @brief 主机仿真用的 usart.h，代替 Core/Inc/usart.h
+ */
+#ifndef __USART_H__
+#define __USART_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+extern UART_HandleTypeDef huart1;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USART_H__ */
@@ -0,0 +1,339 @@
+/**
+ * @file devsim.c
+ * @brief 仿真设备: 与 Core/Src/main.c 相同的闭环在仿真定时器上运行，遥测和命令通道经 USART1 接到一个 pty
+ * @note 启动后在标准输出打印 pty 从端路径，接收端 (pwmcapture_rx 或串口工具) 打开该路径即可，
+ *       与打开设备的串口相同。TIM3 CH1 接回 TIM1，每个捕获样本进入批量差分帧，每 100ms 一个采样帧，
+ *       从 pty 收到的命令经 cmdChannel 执行
+ *       -m 地址 时 USART1 改为 Modbus RTU 从机 (与固件中 USART1_MODBUS 为1相同)，不发送遥测，用主站工具读写寄存器
+ *       仿真时间默认跟随实际时间，-F 时尽快运行，用于测试接收端能否跟上
+ *       -c 文件 时flash最后两页保存在该文件中，启动时由 configStore 读出捕获模式、滤波和PID参数，
+ *       与设备相同，收到保存命令 (CMD_CHANNEL_SAVE 或 Modbus 保存寄存器) 后由主循环写入，下次启动直接使用
+ *
+ *       用法: pwmcapture_devsim [-b 波特率，0为不限速] [-F] [-s 运行秒数] [-l 链接路径] [-m Modbus从机地址] [-c flash文件]
+ */
+#define _GNU_SOURCE
+#include "sim_tim.h"
+#include "sim_uart.h"
+#include "sim_flash.h"
+#include "tim.h"
+#include "usart.h"
+#include "pwmCapture.h"
+#include "PID.h"
+#include "pidLink.h"
+#include "pwmActuator.h"
+#include "loopLatency.h"
+#include "telemetry.h"
+#include "cmdChannel.h"
+#include "modbusRtu.h"
+#include "configStore.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "signal.h"
+#include "time.h"
+#include "fcntl.h"
+#include "unistd.h"
+#include "termios.h"
+
+pwm_Capture_Handle_t pwm_Capture = NULL;
+PIDController_Handle_t pidHandle = NULL;
+pidLink_Handle_t pidLink = NULL;
+pwmActuator_Handle_t pwmActuator = NULL;
+loopLatency_Handle_t loopLatency = NULL;
+telemetry_Handle_t telemetry = NULL;
+cmdChannel_Handle_t cmdChannel = NULL;
+modbusRtu_Handle_t modbus = NULL;
+static modbusRtu_Class_t modbusObj;
+volatile float pidOut = 0;
+volatile float pidSetPoint = 50; // 目标占空比 单位: %
+static volatile bool configSaveRequest = false;
+// 没有保存的配置时使用，直连时对象增益为1，与 sim_main.c 相同的稳定增益
+static configStore_Data_t config = {
+    .capMode = PWM_CAPTURE_MODE_CONTINUOUS,
+    .capFilter = 0,
+    .tickHz = CAPTURE_TICK_HZ,
+    .actInMin = 0,
+    .actInMax = 100,
+    .kp = 0.3f,
+    .ki = 400.0f,
+    .kd = 0.00f,
+    .limMin = 0,
+    .limMax = 100.00f,
+    .limMinInt = 0,
+    .limMaxInt = 100,
+    .tau = 0.001f,
+    .setpoint = 50,
+};
+
+static uint8_t telemetryBuf[4096];
+static uint8_t cmdRxBuf[64];
+static volatile sig_atomic_t devsim_Stop = 0;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1)
+    {
+        pwmCapture_Callback(&pwm_Capture, htim);
+        pidLink_Step(&pidLink);
+        telemetry_PushDelta(&telemetry, &pwm_Capture);
+    }
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART1)
+    {
+        telemetry_TxCpltCallback(&telemetry, huart);
+        modbusRtu_TxCpltCallback(&modbus, huart);
+    }
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    if (huart->Instance == USART1)
+    {
+        cmdChannel_RxEvent(&cmdChannel, huart, Size);
+        modbusRtu_RxEvent(&modbus, huart, Size);
+    }
+}
+
+static void devsim_Signal(int sig)
+{
+    (void)sig;
+    devsim_Stop = 1;
+}
+
+static double devsim_Seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* 打开 pty，从端设为原始模式并保持打开，接收端关闭后写入不会出错 */
+static int devsim_OpenPty(char *name, size_t len, int *slave)
+{
+    struct termios tio;
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname(fd) == NULL) return -1;
+    snprintf(name, len, "%s", ptsname(fd));
+
+    *slave = open(name, O_RDWR | O_NOCTTY);
+    if (*slave < 0) return -1;
+    tcgetattr(*slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(*slave, TCSANOW, &tio);
+    return fd;
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t clk = SystemCoreClock;
+    char name[128];
+    const char *link = NULL;
+    const char *flash = NULL;
+    ConfigStoreState_t configState = CONFIG_STORE_EMPTY;
+    double seconds = 0, t0, sim;
+    uint32_t tick = 0, n = 0;
+    int fast = 0, address = 0, opt, fd, slave;
+
+    while ((opt = getopt(argc, argv, "b:Fs:l:m:c:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'b': huart1.Init.BaudRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'F': fast = 1; break;
+            case 's': seconds = atof(optarg); break;
+            case 'l': link = optarg; break;
+            case 'm': address = atoi(optarg); break;
+            case 'c': flash = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-b baud] [-F] [-s seconds] [-l link] [-m modbus address] [-c flash file]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if (flash != NULL)
+    {
+        if (simFlash_Attach(flash) != 0)
+        {
+            perror(flash);
+            return 1;
+        }
+        configState = configStore_Load(&config);
+        fprintf(stderr, "devsim: %s config from %s: kp %g ki %g kd %g setpoint %g mode %u filter %u\n",
+                configState == CONFIG_STORE_OK ? "loaded" : "no stored", flash, (double)config.kp, (double)config.ki,
+                (double)config.kd, (double)config.setpoint, (unsigned)config.capMode, (unsigned)config.capFilter);
+    }
+    pidSetPoint = config.setpoint;
+
+    fd = devsim_OpenPty(name, sizeof(name), &slave);
+    if (fd < 0)
+    {
+        perror("pty");
+        return 1;
+    }
+    if (link != NULL)
+    {
+        unlink(link);
+        if (symlink(name, link) != 0) perror("symlink");
+    }
+    printf("%s\n", name);
+    fflush(stdout);
+    signal(SIGINT, devsim_Signal);
+    signal(SIGTERM, devsim_Signal);
+
+    simTim_Reset();
+    TIM1->PSC = CAPTURE_TIM_PSC;
+    TIM1->ARR = CAPTURE_TIM_ARR;
+    TIM3->PSC = 35;
+    TIM3->ARR = 999;
+    TIM3->CCR1 = 300; // 从30%开始，与 sim_main.c 的开环阶段相同，PID第一步输出为正
+    simUart_Attach(&huart1, fd);
+
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_1);
+    pwmActuator_conf_t act_conf = {
+        .htim = &htim3,
+        .Channel = TIM_CHANNEL_1,
+        .inMin = config.actInMin,
+        .inMax = config.actInMax,
+    };
+    pwmActuator_Init(&pwmActuator, &act_conf);
+    pwm_Capture_conf_t conf = {
+        .htim = &htim1,
+        .RiseChannel = TIM_CHANNEL_1,
+        .FallChannel = TIM_CHANNEL_2,
+        .tickHz = config.tickHz,
+        .mode = config.capMode,
+    };
+    pwmCapture_Init(&pwm_Capture, &conf);
+    pwmCapture_SetFilter(&pwm_Capture, config.capFilter);
+    // 第一个样本没有上一个上升沿，先开环跑几个周期再接入PID，与 sim_main.c 相同
+    simTim_Loopback(&htim1, &htim3, TIM_CHANNEL_1, 4);
+    PIDController_Conf_t pid_conf = {
+        .kp = config.kp,
+        .ki = config.ki,
+        .kd = config.kd,
+        .limMax = config.limMax,
+        .limMin = config.limMin,
+        .limMaxInt = config.limMaxInt,
+        .limMinInt = config.limMinInt,
+        .tau = config.tau,
+        .T = 0.0005f,
+    };
+    PIDController_Init(&pidHandle, &pid_conf);
+    loopLatency_conf_t lat_conf = {
+        .binWidth = 72,
+    };
+    loopLatency_Init(&loopLatency, &lat_conf);
+    pidLink_conf_t link_conf = {
+        .cap = &pwm_Capture,
+        .pid = &pidHandle,
+        .setpoint = &pidSetPoint,
+        .output = &pidOut,
+        .actuator = &pwmActuator,
+        .latency = &loopLatency,
+        .input = PID_LINK_INPUT_DUTY,
+    };
+    pidLink_Init(&pidLink, &link_conf);
+    if (address != 0)
+    {
+        modbusRtu_conf_t mb_conf = {
+            .huart = &huart1,
+            .address = (uint8_t)address,
+            .dePort = GPIOA,
+            .dePin = GPIO_PIN_8,
+            .cap = &pwm_Capture,
+            .pid = &pidHandle,
+            .setpoint = &pidSetPoint,
+            .link = &pidLink,
+            .latency = &loopLatency,
+            .saveRequest = (flash != NULL) ? &configSaveRequest : NULL,
+        };
+        if (modbusRtu_InitStatic(&modbus, &modbusObj, &mb_conf) != MODBUS_RTU_OK)
+        {
+            fprintf(stderr, "devsim: bad modbus address %d\n", address);
+            return 2;
+        }
+        modbus->filter = config.capFilter;
+    }
+    else
+    {
+        telemetry_conf_t tel_conf = {
+            .huart = &huart1,
+            .buf = telemetryBuf,
+            .size = sizeof(telemetryBuf),
+        };
+        telemetry_Init(&telemetry, &tel_conf);
+        cmdChannel_conf_t cmd_conf = {
+            .huart = &huart1,
+            .rxBuf = cmdRxBuf,
+            .rxSize = sizeof(cmdRxBuf),
+            .cap = &pwm_Capture,
+            .pid = &pidHandle,
+            .setpoint = &pidSetPoint,
+            .telemetry = &telemetry,
+            .saveRequest = (flash != NULL) ? &configSaveRequest : NULL,
+        };
+        cmdChannel_Init(&cmdChannel, &cmd_conf);
+    }
+
+    t0 = devsim_Seconds();
+    while (!devsim_Stop)
+    {
+        simTim_Loopback(&htim1, &htim3, TIM_CHANNEL_1, 1);
+        simUart_Poll(&huart1);
+        if (HAL_GetTick() - tick >= 100)
+        {
+            tick = HAL_GetTick();
+            telemetry_PushSample(&telemetry, &pwm_Capture, &pidHandle);
+        }
+        if (configSaveRequest)
+        {
+            configStore_Source_t src = {
+                .cap = &pwm_Capture,
+                .actuator = &pwmActuator,
+                .pid = &pidHandle,
+                .setpoint = &pidSetPoint,
+            };
+            configStore_Snapshot(&config, &src);
+            configState = configStore_Save(&config);
+            configSaveRequest = false;
+            fprintf(stderr, "devsim: config %s, page erases %lu / %lu\n",
+                    configState == CONFIG_STORE_OK ? "saved" : configState == CONFIG_STORE_UNCHANGED ? "unchanged" : "save failed",
+                    (unsigned long)simFlash_Erases(0), (unsigned long)simFlash_Erases(1));
+        }
+
+        sim = (double)simTim_Now() / (double)clk;
+        if (seconds > 0 && sim >= seconds) break;
+        // 每 10ms 仿真时间与实际时间对齐一次
+        if (!fast && ++n % 20 == 0)
+        {
+            double ahead = sim - (devsim_Seconds() - t0);
+            if (ahead > 0)
+            {
+                struct timespec ts = { (time_t)ahead, (long)((ahead - (double)(time_t)ahead) * 1e9) };
+                nanosleep(&ts, NULL);
+            }
+        }
+    }
+
+    if (modbus != NULL)
+    {
+        fprintf(stderr, "devsim: %.3f s simulated, %lu captures, %lu modbus requests, %lu crc errors, %lu exceptions, %lu bytes dropped (no reader)\n",
+                (double)simTim_Now() / (double)clk, (unsigned long)pwm_Capture->seq, (unsigned long)modbus->requests,
+                (unsigned long)modbus->crcErrors, (unsigned long)modbus->exceptions, (unsigned long)simUart_Dropped(&huart1));
+    }
+    else
+    {
+        fprintf(stderr, "devsim: %.3f s simulated, %lu captures, %lu frames, %lu frames dropped (ring full), %lu bytes dropped (no reader), %lu commands\n",
+                (double)simTim_Now() / (double)clk, (unsigned long)pwm_Capture->seq, (unsigned long)telemetry->frames,
+                (unsigned long)telemetry->dropped, (unsigned long)simUart_Dropped(&huart1), (unsigned long)cmdChannel->commands);
+    }
+
+    if (link != NULL) unlink(link);
+    close(slave);
+    close(fd);
+    return 0;
+}
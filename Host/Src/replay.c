@@ -0,0 +1,337 @@
+/**
+ * @file replay.c
+ * @brief 边沿记录回放，把记录的边沿经仿真定时器送入未修改的 pwmCapture
+ * @note 输入格式按文件头自动识别:
+ *       1. CSV: 每行 "时间(秒),电平(0/1)"，与逻辑分析仪导出的数字通道格式相同，非数字开头的行(表头)跳过
+ *          第一行为初始电平，之后电平变化处为一个边沿
+ *       2. 二进制: 4字节 "EDG1"，4字节 计时频率(Hz)，之后每个边沿4字节，均为小端
+ *          bit31 为边沿后的电平，bit0~30 为距上一个边沿的计时数
+ *       对每个完成的样本输出一行CSV，与理论值(由边沿时刻直接计算)比较，误差超过容差记为不一致
+ *       样本由上升沿和下降沿中后到的一个完成，取决于初始电平；开启捕获后的第一个样本记为 partial，不比较
+ *       应出现样本而未出现记为丢失，汇总和吞吐量输出到标准错误
+ *
+ *       用法: pwmcapture_replay [-q] [-t 容差计数] [-o 输出二进制] 文件
+ */
+#include "sim_tim.h"
+#include "tim.h"
+#include "pwmCapture.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "math.h"
+#include "time.h"
+#include "unistd.h"
+
+#define REPLAY_MAGIC "EDG1"
+
+typedef struct
+{
+    uint64_t cycle; // 边沿时刻 单位: CPU周期
+    uint8_t level;  // 边沿后的电平
+} replay_Edge_t;
+
+typedef struct
+{
+    replay_Edge_t *edge;
+    size_t num;
+    size_t cap;
+} replay_Log_t;
+
+pwm_Capture_Handle_t pwm_Capture = NULL;
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1)
+    {
+        pwmCapture_Callback(&pwm_Capture, htim);
+    }
+}
+
+static void replay_Push(replay_Log_t *log, uint64_t cycle, uint8_t level)
+{
+    if (log->num == log->cap)
+    {
+        log->cap = log->cap ? log->cap * 2 : 4096;
+        log->edge = realloc(log->edge, log->cap * sizeof(replay_Edge_t));
+        if (log->edge == NULL)
+        {
+            fprintf(stderr, "replay: out of memory\n");
+            exit(1);
+        }
+    }
+    log->edge[log->num].cycle = cycle;
+    log->edge[log->num].level = level;
+    log->num++;
+}
+
+static uint32_t replay_Le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void replay_PutLe32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static int replay_LoadBin(FILE *f, replay_Log_t *log)
+{
+    uint8_t buf[4];
+    uint32_t tickHz;
+    unsigned __int128 ticks = 0;
+
+    if (fread(buf, 1, 4, f) != 4) return -1;
+    tickHz = replay_Le32(buf);
+    if (tickHz == 0) return -1;
+
+    while (fread(buf, 1, 4, f) == 4)
+    {
+        uint32_t rec = replay_Le32(buf);
+        ticks += rec & 0x7FFFFFFFU;
+        replay_Push(log, (uint64_t)(ticks * SystemCoreClock / tickHz), (uint8_t)(rec >> 31));
+    }
+    return 0;
+}
+
+static int replay_LoadCsv(FILE *f, replay_Log_t *log)
+{
+    char line[256];
+    double t0 = 0.0;
+    int first = 1;
+
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        char *end;
+        char *p = line;
+        double t;
+        long level;
+
+        while (*p == ' ' || *p == '\t') p++;
+        if (!((*p >= '0' && *p <= '9') || *p == '-' || *p == '.')) continue; // 表头或空行
+
+        t = strtod(p, &end);
+        if (end == p) continue;
+        p = end;
+        while (*p == ',' || *p == ' ' || *p == '\t' || *p == ';') p++;
+        level = strtol(p, &end, 10);
+        if (end == p) continue;
+
+        if (first)
+        {
+            t0 = t;
+            first = 0;
+        }
+        replay_Push(log, (uint64_t)llround((t - t0) * (double)SystemCoreClock), level != 0);
+    }
+    return first ? -1 : 0;
+}
+
+/* 以CPU周期为计时单位写出二进制格式 */
+static int replay_SaveBin(const char *path, const replay_Log_t *log)
+{
+    FILE *f = fopen(path, "wb");
+    uint8_t buf[4];
+    uint64_t last = 0;
+    size_t i;
+
+    if (f == NULL) return -1;
+    fwrite(REPLAY_MAGIC, 1, 4, f);
+    replay_PutLe32(buf, SystemCoreClock);
+    fwrite(buf, 1, 4, f);
+    for (i = 0; i < log->num; i++)
+    {
+        uint64_t delta = log->edge[i].cycle - last;
+        if (delta > 0x7FFFFFFFU)
+        {
+            fclose(f);
+            fprintf(stderr, "replay: gap too long for binary format at edge %zu\n", i);
+            return -1;
+        }
+        replay_PutLe32(buf, (uint32_t)delta | ((uint32_t)log->edge[i].level << 31));
+        fwrite(buf, 1, 4, f);
+        last = log->edge[i].cycle;
+    }
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    replay_Log_t log = { NULL, 0, 0 };
+    const char *out = NULL;
+    int quiet = 0;
+    double tolTicks = 1.0;
+    int opt;
+    FILE *f;
+    char magic[4];
+    size_t i;
+    uint8_t level, doneLevel;
+    uint64_t lastRise = 0, prevRise = 0, lastHigh = 0;
+    uint8_t haveRise = 0, havePrevRise = 0, haveHigh = 0;
+    uint32_t lastSeq = 0;
+    unsigned long samples = 0, dropped = 0, mismatched = 0, unexpected = 0, edges = 0;
+    double tickPeriod, tol, clk, t0, t1;
+    struct timespec ts;
+
+    while ((opt = getopt(argc, argv, "qt:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'q': quiet = 1; break;
+            case 't': tolTicks = atof(optarg); break;
+            case 'o': out = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-q] [-t tol_ticks] [-o out.bin] edges.csv|edges.bin\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-q] [-t tol_ticks] [-o out.bin] edges.csv|edges.bin\n", argv[0]);
+        return 2;
+    }
+
+    f = fopen(argv[optind], "rb");
+    if (f == NULL)
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (fread(magic, 1, 4, f) == 4 && memcmp(magic, REPLAY_MAGIC, 4) == 0)
+    {
+        opt = replay_LoadBin(f, &log);
+    }
+    else
+    {
+        rewind(f);
+        opt = replay_LoadCsv(f, &log);
+    }
+    fclose(f);
+    if (opt != 0 || log.num == 0)
+    {
+        fprintf(stderr, "replay: no edges in %s\n", argv[optind]);
+        return 1;
+    }
+    if (out != NULL && replay_SaveBin(out, &log) != 0)
+    {
+        fprintf(stderr, "replay: cannot write %s\n", out);
+        return 1;
+    }
+
+    /* 与 Core/Src/tim.c 相同的 TIM1 配置 */
+    simTim_Reset();
+    TIM1->PSC = CAPTURE_TIM_PSC;
+    TIM1->ARR = CAPTURE_TIM_ARR;
+    pwm_Capture_conf_t conf = {
+        .htim = &htim1,
+        .RiseChannel = TIM_CHANNEL_1,
+        .FallChannel = TIM_CHANNEL_2,
+        .tickHz = CAPTURE_TICK_HZ,
+        .mode = PWM_CAPTURE_MODE_CONTINUOUS,
+    };
+    if (pwmCapture_Init(&pwm_Capture, &conf) != PWM_CAPTURE_OK)
+    {
+        fprintf(stderr, "replay: pwmCapture_Init failed\n");
+        return 1;
+    }
+
+    clk = (double)SystemCoreClock;
+    tickPeriod = 1.0 / (double)CAPTURE_TICK_HZ;
+    tol = tolTicks * tickPeriod;
+    if (!quiet)
+    {
+        printf("seq,time_s,freq_hz,duty_pct,pulse_ticks,period_s,status\n");
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    t0 = (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+
+    /* 上升沿和下降沿都捕获到后才完成样本: 初始为低电平时由下降沿完成，初始为高电平时由上升沿完成
+     * 周期为最近一个完整的 上升沿→上升沿 间隔，高电平时间为最近一个下降沿与其前一个上升沿之差 */
+    level = log.edge[0].level;
+    doneLevel = level;
+    for (i = 1; i < log.num; i++)
+    {
+        const replay_Edge_t *e = &log.edge[i];
+        uint8_t expected = 0, partial = 0;
+        double expPeriod = 0.0, expHigh = 0.0;
+
+        if (e->level == level) continue; // 电平未变化
+        level = e->level;
+        edges++;
+
+        if (level)
+        {
+            prevRise = lastRise;
+            havePrevRise = haveRise;
+            lastRise = e->cycle;
+            haveRise = 1;
+        }
+        else if (haveRise)
+        {
+            lastHigh = e->cycle - lastRise;
+            haveHigh = 1;
+        }
+
+        if (level == doneLevel)
+        {
+            if (havePrevRise && haveHigh)
+            {
+                expected = 1;
+                expPeriod = (double)(lastRise - prevRise) / clk;
+                expHigh = (double)lastHigh / clk;
+            }
+            else
+            {
+                partial = 1; // 第一个样本的周期从开启捕获算起，不与理论值比较
+            }
+        }
+
+        simTim_Edge(&htim1, level, e->cycle);
+
+        if (pwm_Capture->seq != lastSeq)
+        {
+            const pwm_Capture_Result_t *r = &pwm_Capture->result;
+            const char *status = "ok";
+
+            lastSeq = pwm_Capture->seq;
+            samples++;
+            if (partial)
+            {
+                status = "partial";
+            }
+            else if (!expected)
+            {
+                status = "unexpected";
+                unexpected++;
+            }
+            else if (fabs((double)r->period - expPeriod) > tol || fabs((double)r->pulseWidth * tickPeriod - expHigh) > tol)
+            {
+                status = "mismatch";
+                mismatched++;
+            }
+            if (!quiet)
+            {
+                printf("%lu,%.9f,%lu,%.4f,%lu,%.9f,%s\n", (unsigned long)lastSeq, (double)e->cycle / clk,
+                       (unsigned long)r->freq, r->duty, (unsigned long)r->pulseWidth, r->period, status);
+            }
+        }
+        else if (expected)
+        {
+            dropped++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    t1 = (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+
+    fprintf(stderr, "edges=%lu samples=%lu dropped=%lu mismatched=%lu unexpected=%lu time=%.3fs throughput=%.2f M edges/s\n",
+            edges, samples, dropped, mismatched, unexpected, t1 - t0, (double)edges / (t1 - t0) * 1e-6);
+
+    pwmCapture_Delete(&pwm_Capture);
+    free(log.edge);
+    return (dropped || mismatched) ? 3 : 0;
+}
@@ -0,0 +1,135 @@
+#include "sim_flash.h"
+#include "stdio.h"
+#include "string.h"
+
+uint8_t simFlash[SIM_FLASH_SIZE] = {[0 ... SIM_FLASH_SIZE - 1] = 0xFF}; // 上电时为已擦除
+
+static FILE *simFlash_File = NULL;
+static int simFlash_Unlocked = 0;
+static int32_t simFlash_Budget = -1; // 剩余可写半字数，-1 为不限
+static uint32_t simFlash_EraseCount[SIM_FLASH_SIZE / FLASH_PAGE_SIZE];
+
+static void simFlash_Sync(void)
+{
+    if (simFlash_File != NULL)
+    {
+        rewind(simFlash_File);
+        fwrite(simFlash, 1, sizeof(simFlash), simFlash_File);
+        fflush(simFlash_File);
+    }
+}
+
+/**
+ * @brief 用文件保存flash内容，文件不存在时创建 (内容为已擦除)
+ *
+ * @param path 文件路径
+ * @return int 0 成功 / -1 失败
+ */
+int simFlash_Attach(const char *path)
+{
+    simFlash_File = fopen(path, "r+b");
+    if (simFlash_File != NULL)
+    {
+        if (fread(simFlash, 1, sizeof(simFlash), simFlash_File) != sizeof(simFlash))
+        {
+            memset(simFlash, 0xFF, sizeof(simFlash));
+        }
+        return 0;
+    }
+    simFlash_File = fopen(path, "w+b");
+    if (simFlash_File == NULL)
+    {
+        return -1;
+    }
+    simFlash_Sync();
+    return 0;
+}
+
+void simFlash_FailAfter(int32_t halfwords)
+{
+    simFlash_Budget = halfwords;
+}
+
+uint32_t simFlash_Erases(uint32_t page)
+{
+    return page < SIM_FLASH_SIZE / FLASH_PAGE_SIZE ? simFlash_EraseCount[page] : 0;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    simFlash_Unlocked = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    simFlash_Unlocked = 0;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef simFlash_Halfword(uint32_t Address, uint16_t data)
+{
+    uint32_t off = Address - SIM_FLASH_BASE;
+    uint16_t old;
+
+    if (Address < SIM_FLASH_BASE || off + 2U > SIM_FLASH_SIZE || (off & 1U) != 0)
+    {
+        return HAL_ERROR;
+    }
+    if (simFlash_Budget == 0)
+    {
+        return HAL_ERROR;
+    }
+    if (simFlash_Budget > 0)
+    {
+        simFlash_Budget--;
+    }
+    memcpy(&old, &simFlash[off], 2);
+    if (old != 0xFFFFU && data != 0)
+    {
+        return HAL_ERROR; // PGERR
+    }
+    memcpy(&simFlash[off], &data, 2);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    HAL_StatusTypeDef status;
+
+    if (!simFlash_Unlocked)
+    {
+        return HAL_ERROR;
+    }
+    status = simFlash_Halfword(Address, (uint16_t)Data);
+    if (status == HAL_OK && TypeProgram == FLASH_TYPEPROGRAM_WORD)
+    {
+        status = simFlash_Halfword(Address + 2U, (uint16_t)(Data >> 16));
+    }
+    simFlash_Sync();
+    return status;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    uint32_t i, off;
+
+    *PageError = 0xFFFFFFFFU;
+    if (!simFlash_Unlocked || pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES)
+    {
+        return HAL_ERROR;
+    }
+    for (i = 0; i < pEraseInit->NbPages; i++)
+    {
+        off = pEraseInit->PageAddress + i * FLASH_PAGE_SIZE - SIM_FLASH_BASE;
+        if (pEraseInit->PageAddress < SIM_FLASH_BASE || off + FLASH_PAGE_SIZE > SIM_FLASH_SIZE)
+        {
+            *PageError = pEraseInit->PageAddress + i * FLASH_PAGE_SIZE;
+            return HAL_ERROR;
+        }
+        memset(&simFlash[off], 0xFF, FLASH_PAGE_SIZE);
+        simFlash_EraseCount[off / FLASH_PAGE_SIZE]++;
+    }
+    simFlash_Sync();
+    return HAL_OK;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file sim_main.c
+ * @brief 主机仿真示例，与 Core/Src/main.c 相同的配置在仿真定时器上运行
+ * @note 1. 开环: 输入 1kHz 30% 的PWM，打印捕获结果
+ *       2. 闭环: TIM3 CH1 接回 TIM1 (PA6 -> PA8)，pidLink 把占空比调到设定值
+ *       3. 吞吐量: 连续输入边沿，统计每秒处理的捕获样本数
+ */
+#include "sim_tim.h"
+#include "tim.h"
+#include "pwmCapture.h"
+#include "PID.h"
+#include "pidLink.h"
+#include "pwmActuator.h"
+#include "loopLatency.h"
+#include "stdio.h"
+#include "time.h"
+
+pwm_Capture_Handle_t pwm_Capture = NULL;
+PIDController_Handle_t pidHandle = NULL;
+pidLink_Handle_t pidLink = NULL;
+pwmActuator_Handle_t pwmActuator = NULL;
+loopLatency_Handle_t loopLatency = NULL;
+volatile float pidOut = 0;
+volatile float pidSetPoint = 50; // 目标占空比 单位: %
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1)
+    {
+        pwmCapture_Callback(&pwm_Capture, htim);
+        pidLink_Step(&pidLink);
+    }
+}
+
+/* 与 MX_TIM1_Init / MX_TIM3_Init 相同的分频和重装载值 */
+static void sim_TimInit(void)
+{
+    TIM1->PSC = CAPTURE_TIM_PSC;
+    TIM1->ARR = CAPTURE_TIM_ARR;
+    TIM3->PSC = 35;
+    TIM3->ARR = 999;
+    TIM3->CCR1 = 800;
+}
+
+static double sim_Seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+    const uint64_t clk = SystemCoreClock;
+    uint32_t i, n;
+    double t0, t1;
+
+    simTim_Reset();
+    sim_TimInit();
+
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_1);
+    pwmActuator_conf_t act_conf = {
+        .htim = &htim3,
+        .Channel = TIM_CHANNEL_1,
+        .inMin = 0,
+        .inMax = 100,
+    };
+    pwmActuator_Init(&pwmActuator, &act_conf);
+    pwm_Capture_conf_t conf = {
+        .htim = &htim1,
+        .RiseChannel = TIM_CHANNEL_1,
+        .FallChannel = TIM_CHANNEL_2,
+        .tickHz = CAPTURE_TICK_HZ,
+        .mode = PWM_CAPTURE_MODE_CONTINUOUS,
+    };
+    pwmCapture_Init(&pwm_Capture, &conf);
+
+    /* 1. 开环 */
+    for (i = 0; i < 4; i++)
+    {
+        simTim_Pulse(&htim1, clk * 3 / 10000, clk / 1000);
+    }
+    printf("open loop: freq=%lu Hz duty=%.2f %% pulse=%lu period=%.6f s\n",
+           (unsigned long)pwmCapture_getFreq(pwm_Capture), pwmCapture_getDuty(pwm_Capture),
+           (unsigned long)pwmCapture_getPulseWidth(pwm_Capture), pwm_Capture->result.period);
+
+    /* 2. 闭环，直连时对象增益为1，比例增益需小于1，主要靠积分 */
+    PIDController_Conf_t pid_conf = {
+        .kp = 0.3f,
+        .ki = 400.0f,
+        .kd = 0.00f,
+        .limMax = 100.00f,
+        .limMin = 0,
+        .limMaxInt = 100,
+        .limMinInt = 0,
+        .tau = 0.001f,
+        .T = 0.0005f,
+    };
+    PIDController_Init(&pidHandle, &pid_conf);
+    loopLatency_conf_t lat_conf = {
+        .binWidth = 72,
+    };
+    loopLatency_Init(&loopLatency, &lat_conf);
+    pidLink_conf_t link_conf = {
+        .cap = &pwm_Capture,
+        .pid = &pidHandle,
+        .setpoint = &pidSetPoint,
+        .output = &pidOut,
+        .actuator = &pwmActuator,
+        .latency = &loopLatency,
+        .input = PID_LINK_INPUT_DUTY,
+    };
+    pidLink_Init(&pidLink, &link_conf);
+
+    simTim_SetLatency(120);
+    simTim_Loopback(&htim1, &htim3, TIM_CHANNEL_1, 10);
+    loopLatency_Reset(&loopLatency); // 不统计开环阶段留下的样本
+    simTim_Loopback(&htim1, &htim3, TIM_CHANNEL_1, 2000);
+    printf("closed loop: setpoint=%.2f %% duty=%.2f %% out=%.2f steps=%lu latency min/mean/max=%lu/%lu/%lu cycles\n",
+           pidSetPoint, pwmCapture_getDuty(pwm_Capture), pidOut, (unsigned long)pidLink->steps,
+           (unsigned long)loopLatency->min, (unsigned long)loopLatency_getMean(loopLatency), (unsigned long)loopLatency->max);
+
+    /* 3. 吞吐量 */
+    pidLink_Delete(&pidLink);
+    simTim_SetLatency(0);
+    n = 2000000;
+    t0 = sim_Seconds();
+    for (i = 0; i < n; i++)
+    {
+        simTim_Pulse(&htim1, clk / 4000 + (i & 63), clk / 1000);
+    }
+    t1 = sim_Seconds();
+    printf("throughput: %lu samples in %.3f s, %.2f M samples/s\n",
+           (unsigned long)n, t1 - t0, (double)n / (t1 - t0) * 1e-6);
+
+    pwmCapture_Delete(&pwm_Capture);
+    pwmActuator_Delete(&pwmActuator);
+    loopLatency_Delete(&loopLatency);
+    return 0;
+}
@@ -0,0 +1,302 @@
+#include "sim_tim.h"
+#include "tim.h"
+#include "stdlib.h"
+#include "string.h"
+
+TIM_TypeDef simTIM1;
+TIM_TypeDef simTIM3;
+DWT_Type simDWT;
+CoreDebug_Type simCoreDebug;
+SCB_Type simSCB;
+
+TIM_HandleTypeDef htim1 = { .Instance = TIM1, .Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED };
+TIM_HandleTypeDef htim3 = { .Instance = TIM3, .Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED };
+
+uint32_t SystemCoreClock = 72000000U;
+uint32_t simPrimask;
+
+typedef struct
+{
+    TIM_TypeDef *tim;
+    TIM_HandleTypeDef *htim;
+    simTim_IRQ_t irq;
+    uint64_t resetCycle; // 计数器上次清零的时刻
+    uint32_t sr;         // SR 的实际值
+} simTim_State_t;
+
+static simTim_State_t simTim[2];
+static uint64_t simNow;     // 当前仿真时刻 单位: CPU周期
+static uint32_t simLatency; // 中断延迟 单位: CPU周期
+
+static simTim_State_t *simTim_Find(TIM_TypeDef *tim)
+{
+    return (tim == TIM1) ? &simTim[0] : (tim == TIM3) ? &simTim[1] : NULL;
+}
+
+/* 程序只能把 SR 的位写0，与写入后的值相与得到实际值 */
+static uint32_t simTim_Sync(simTim_State_t *st)
+{
+    st->sr &= st->tim->SR;
+    st->tim->SR = st->sr;
+    return st->sr;
+}
+
+static uint32_t simTim_Counter(simTim_State_t *st, uint64_t cycle)
+{
+    TIM_TypeDef *tim = st->tim;
+    return (uint32_t)(((cycle - st->resetCycle) / (tim->PSC + 1U)) % ((uint64_t)tim->ARR + 1U));
+}
+
+static void simTim_SetCycle(uint64_t cycle)
+{
+    if ((CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        DWT->CYCCNT = (uint32_t)cycle;
+    }
+}
+
+/**
+ * @brief 清空全部仿真寄存器和状态
+ */
+void simTim_Reset(void)
+{
+    memset(&simTIM1, 0, sizeof(simTIM1));
+    memset(&simTIM3, 0, sizeof(simTIM3));
+    memset(&simDWT, 0, sizeof(simDWT));
+    memset(&simCoreDebug, 0, sizeof(simCoreDebug));
+    memset(&simSCB, 0, sizeof(simSCB));
+    memset(simTim, 0, sizeof(simTim));
+    simTIM1.ARR = 0xFFFFU;
+    simTIM3.ARR = 0xFFFFU;
+    simTim[0].tim = TIM1;
+    simTim[0].htim = &htim1;
+    simTim[1].tim = TIM3;
+    simTim[1].htim = &htim3;
+    htim1.Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+    htim3.Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+    memset((void *)htim1.ChannelState, 0, sizeof(htim1.ChannelState));
+    memset((void *)htim3.ChannelState, 0, sizeof(htim3.ChannelState));
+    simNow = 0;
+    simLatency = 0;
+    simPrimask = 0;
+}
+
+/**
+ * @brief 设置定时器的中断函数
+ *
+ * @param htim 定时器句柄
+ * @param irq 中断函数，如 pwmCapture_static.h 生成的 name_IRQHandler，NULL 时使用 HAL_TIM_IRQHandler()
+ */
+void simTim_SetIRQ(TIM_HandleTypeDef *htim, simTim_IRQ_t irq)
+{
+    simTim_State_t *st = simTim_Find(htim->Instance);
+    if (st == NULL) return;
+    st->htim = htim;
+    st->irq = irq;
+}
+
+/**
+ * @brief 设置边沿到进入中断的延迟
+ *
+ * @param cycles 单位: CPU周期
+ */
+void simTim_SetLatency(uint32_t cycles)
+{
+    simLatency = cycles;
+}
+
+/**
+ * @brief 输入一个边沿
+ *
+ * @param htim 定时器句柄
+ * @param rising 1: 上升沿 0: 下降沿
+ * @param cycle 边沿时刻 单位: CPU周期，不能早于上一个边沿
+ */
+void simTim_Edge(TIM_HandleTypeDef *htim, uint8_t rising, uint64_t cycle)
+{
+    simTim_State_t *st = simTim_Find(htim->Instance);
+    TIM_TypeDef *tim;
+    uint32_t cnt, sr;
+
+    if (st == NULL) return;
+    tim = st->tim;
+    if (cycle > simNow) simNow = cycle;
+    simTim_SetCycle(cycle);
+
+    if (!(tim->CR1 & TIM_CR1_CEN)) return;
+
+    cnt = simTim_Counter(st, cycle);
+    sr = simTim_Sync(st);
+
+    if (rising)
+    {
+        if (tim->CCER & TIM_CCER_CC1E)
+        {
+            if (sr & TIM_SR_CC1IF) sr |= TIM_SR_CC1OF;
+            tim->CCR1 = cnt;
+            sr |= TIM_SR_CC1IF;
+        }
+        st->resetCycle = cycle; // 从模式复位
+    }
+    else if (tim->CCER & TIM_CCER_CC2E)
+    {
+        if (sr & TIM_SR_CC2IF) sr |= TIM_SR_CC1OF << 1;
+        tim->CCR2 = cnt;
+        sr |= TIM_SR_CC2IF;
+    }
+
+    st->sr = sr;
+    tim->SR = sr;
+
+    if ((sr & tim->DIER & (TIM_IT_CC1 | TIM_IT_CC2 | TIM_IT_CC3 | TIM_IT_CC4)) && simPrimask == 0U)
+    {
+        tim->CNT = simTim_Counter(st, cycle + simLatency);
+        simTim_SetCycle(cycle + simLatency);
+        if (st->irq != NULL)
+        {
+            st->irq();
+        }
+        else
+        {
+            HAL_TIM_IRQHandler(st->htim);
+        }
+        simTim_Sync(st);
+    }
+}
+
+/**
+ * @brief 从当前时刻输入一个PWM周期: 上升沿，high 后下降沿，period 后结束
+ *
+ * @param htim 定时器句柄
+ * @param high 高电平时间 单位: CPU周期，为0或不小于 period 时只有上升沿
+ * @param period 周期 单位: CPU周期
+ */
+void simTim_Pulse(TIM_HandleTypeDef *htim, uint64_t high, uint64_t period)
+{
+    uint64_t t = simNow;
+
+    simTim_Edge(htim, 1, t);
+    if (high > 0 && high < period)
+    {
+        simTim_Edge(htim, 0, t + high);
+    }
+    simNow = t + period;
+}
+
+/**
+ * @brief 把 out 的PWM输出接到 in 的捕获输入，运行 periods 个PWM周期
+ * @note 比较值在每个周期开始时装载，与开启预装载时的硬件行为相同
+ *
+ * @param in 捕获定时器
+ * @param out PWM定时器，需已由 HAL_TIM_PWM_Start() 开启
+ * @param channel PWM通道 TIM_CHANNEL_1 ~ TIM_CHANNEL_4
+ * @param periods 运行的周期数
+ */
+void simTim_Loopback(TIM_HandleTypeDef *in, TIM_HandleTypeDef *out, uint32_t channel, uint32_t periods)
+{
+    TIM_TypeDef *tim = out->Instance;
+
+    while (periods--)
+    {
+        uint64_t psc = tim->PSC + 1U;
+        uint64_t period = psc * ((uint64_t)tim->ARR + 1U);
+        uint64_t ccr = *(&tim->CCR1 + (channel >> 2));
+
+        if (!(tim->CR1 & TIM_CR1_CEN)) return;
+        simTim_Pulse(in, psc * ccr, period);
+    }
+}
+
+/**
+ * @brief 获取当前仿真时刻 单位: CPU周期
+ */
+uint64_t simTim_Now(void)
+{
+    return simNow;
+}
+
+void simTim_ClearFlag(TIM_TypeDef *tim, uint32_t flag)
+{
+    simTim_State_t *st = simTim_Find(tim);
+
+    if (st == NULL)
+    {
+        tim->SR = ~flag;
+        return;
+    }
+    simTim_Sync(st);
+    st->sr &= ~flag;
+    tim->SR = st->sr;
+}
+
+/* HAL --------------------------------------------------------------------------*/
+
+/* 与HAL相同，通道为BUSY (已开启且未经 Stop_IT) 时返回错误，不修改寄存器 */
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    if (Channel > TIM_CHANNEL_4) return HAL_ERROR;
+    if (htim->ChannelState[Channel >> 2] == HAL_TIM_CHANNEL_STATE_BUSY) return HAL_ERROR;
+    htim->ChannelState[Channel >> 2] = HAL_TIM_CHANNEL_STATE_BUSY;
+    htim->Instance->DIER |= TIM_IT_CC1 << (Channel >> 2);
+    htim->Instance->CCER |= TIM_CCER_CC1E << Channel;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    if (Channel > TIM_CHANNEL_4) return HAL_ERROR;
+    htim->ChannelState[Channel >> 2] = HAL_TIM_CHANNEL_STATE_READY;
+    htim->Instance->DIER &= ~(TIM_IT_CC1 << (Channel >> 2));
+    htim->Instance->CCER &= ~(TIM_CCER_CC1E << Channel);
+    if ((htim->Instance->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E)) == 0U)
+    {
+        htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    if (Channel > TIM_CHANNEL_4) return HAL_ERROR;
+    htim->Instance->CCER |= TIM_CCER_CC1E << Channel;
+    htim->Instance->BDTR |= TIM_BDTR_MOE;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+/* 与HAL库相同: 按通道顺序检查标志，清除后设置 Channel 并调用捕获回调 */
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+    simTim_State_t *st = simTim_Find(htim->Instance);
+    uint8_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        uint32_t flag = TIM_FLAG_CC1 << i;
+        uint32_t sr = (st != NULL) ? simTim_Sync(st) : htim->Instance->SR;
+
+        if ((sr & flag) && (htim->Instance->DIER & flag))
+        {
+            simTim_ClearFlag(htim->Instance, flag);
+            htim->Channel = (HAL_TIM_ActiveChannel)(HAL_TIM_ACTIVE_CHANNEL_1 << i);
+            HAL_TIM_IC_CaptureCallback(htim);
+            htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+        }
+    }
+}
+
+__attribute__((weak)) void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(simNow / (SystemCoreClock / 1000U));
+}
+
+void Error_Handler(void)
+{
+    abort();
+}
@@ -0,0 +1,223 @@
+#include "sim_uart.h"
+#include "sim_tim.h"
+#include "usart.h"
+#include "errno.h"
+#include "fcntl.h"
+#include "unistd.h"
+
+USART_TypeDef simUSART1;
+GPIO_TypeDef simGPIOA;
+
+UART_HandleTypeDef huart1 = { USART1, { 115200U }, NULL, 0, HAL_UART_STATE_READY, HAL_UART_STATE_READY, HAL_UART_RXEVENT_TC };
+
+typedef struct
+{
+    UART_HandleTypeDef *huart;
+    int fd;
+    const uint8_t *tx;   // 正在发送的数据
+    uint16_t txLen;
+    uint64_t txDone;     // 发送完成时刻 单位: CPU周期
+    uint64_t lineFree;   // 上一次发送结束的时刻，连续发送时紧接着开始
+    uint16_t rxPos;      // DMA在接收缓冲区中的写入位置
+    uint32_t dropped;    // 对端没有读而丢弃的字节数
+} simUart_State_t;
+
+static simUart_State_t simUart = { NULL, -1, NULL, 0, 0, 0, 0, 0 };
+
+static simUart_State_t *simUart_Find(UART_HandleTypeDef *huart)
+{
+    return (huart != NULL && huart == simUart.huart) ? &simUart : NULL;
+}
+
+/**
+ * @brief 把串口接到文件描述符，描述符设为非阻塞
+ *
+ * @param huart 串口句柄
+ * @param fd 文件描述符
+ */
+void simUart_Attach(UART_HandleTypeDef *huart, int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    simUart.huart = huart;
+    simUart.fd = fd;
+    simUart.tx = NULL;
+    simUart.txLen = 0;
+    simUart.lineFree = simTim_Now();
+    simUart.rxPos = 0;
+    simUart.dropped = 0;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+}
+
+static void simUart_Write(simUart_State_t *st)
+{
+    const uint8_t *p = st->tx;
+    size_t left = st->txLen;
+    ssize_t n;
+
+    while (left > 0)
+    {
+        n = write(st->fd, p, left);
+        if (n > 0)
+        {
+            p += n;
+            left -= (size_t)n;
+        }
+        else if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            st->dropped += (uint32_t)left;
+            break;
+        }
+    }
+}
+
+static void simUart_Receive(simUart_State_t *st)
+{
+    UART_HandleTypeDef *huart = st->huart;
+    uint8_t tmp[256];
+    uint16_t half = huart->RxXferSize / 2U;
+    ssize_t n, i;
+    uint8_t got = 0;
+
+    while ((n = read(st->fd, tmp, sizeof(tmp))) > 0)
+    {
+        got = 1;
+        for (i = 0; i < n && huart->RxState == HAL_UART_STATE_BUSY_RX; i++)
+        {
+            huart->pRxBuffPtr[st->rxPos++] = tmp[i];
+            if (st->rxPos == half)
+            {
+                huart->RxEventType = HAL_UART_RXEVENT_HT;
+                HAL_UARTEx_RxEventCallback(huart, half);
+            }
+            else if (st->rxPos == huart->RxXferSize)
+            {
+                st->rxPos = 0;
+                huart->RxEventType = HAL_UART_RXEVENT_TC;
+                HAL_UARTEx_RxEventCallback(huart, huart->RxXferSize);
+            }
+        }
+    }
+
+    // 一次读取结束当作空闲线，与HAL相同，位置在缓冲区开头时不回调
+    if (got && st->rxPos != 0 && huart->RxState == HAL_UART_STATE_BUSY_RX)
+    {
+        huart->RxEventType = HAL_UART_RXEVENT_IDLE;
+        HAL_UARTEx_RxEventCallback(huart, st->rxPos);
+    }
+}
+
+/**
+ * @brief 推进串口: 完成到期的发送，读取新收到的数据
+ *
+ * @param huart 串口句柄
+ */
+void simUart_Poll(UART_HandleTypeDef *huart)
+{
+    simUart_State_t *st = simUart_Find(huart);
+
+    if (st == NULL) return;
+
+    while (huart->gState == HAL_UART_STATE_BUSY_TX && simTim_Now() >= st->txDone)
+    {
+        simUart_Write(st);
+        st->lineFree = st->txDone;
+        huart->gState = HAL_UART_STATE_READY;
+        HAL_UART_TxCpltCallback(huart);
+    }
+
+    if (huart->RxState == HAL_UART_STATE_BUSY_RX)
+    {
+        simUart_Receive(st);
+    }
+}
+
+/**
+ * @brief 获取因对端没有读而丢弃的字节数
+ */
+uint32_t simUart_Dropped(UART_HandleTypeDef *huart)
+{
+    simUart_State_t *st = simUart_Find(huart);
+    return (st != NULL) ? st->dropped : 0;
+}
+
+/* HAL --------------------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    simUart_State_t *st = simUart_Find(huart);
+    uint64_t start;
+
+    if (st == NULL || pData == NULL || Size == 0) return HAL_ERROR;
+    if (huart->gState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    start = (simTim_Now() > st->lineFree) ? simTim_Now() : st->lineFree;
+    st->tx = pData;
+    st->txLen = Size;
+    st->txDone = start;
+    if (huart->Init.BaudRate != 0)
+    {
+        st->txDone += (uint64_t)Size * 10U * SystemCoreClock / huart->Init.BaudRate;
+    }
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortTransmit(UART_HandleTypeDef *huart)
+{
+    huart->gState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    simUart_State_t *st = simUart_Find(huart);
+
+    if (st == NULL || pData == NULL || Size == 0) return HAL_ERROR;
+    if (huart->RxState != HAL_UART_STATE_READY) return HAL_BUSY;
+
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    st->rxPos = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
+{
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_UART_RxEventTypeTypeDef HAL_UARTEx_GetRxEventType(UART_HandleTypeDef *huart)
+{
+    return huart->RxEventType;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState != GPIO_PIN_RESET) GPIOx->ODR |= GPIO_Pin;
+    else GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    (void)huart;
+    (void)Size;
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
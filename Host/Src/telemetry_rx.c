@@ -0,0 +1,562 @@
+/**
+ * @file telemetry_rx.c
+ * @brief 遥测接收: 从串口或 pty 读取遥测帧，解码后输出 CSV / JSON / 环形文件，并统计速率、丢失和延迟
+ * @note 按 0x00 分帧，帧在读缓冲区中原地解码 (telemetryCodec_Unframe 输入输出同一地址)，只有跨两次读取的
+ *       半帧会移到缓冲区开头，解码不再拷贝
+ *       丢失按批量差分帧的 seq 间隔统计，采样帧是每 100ms 的抽样，不计入；seq 变小视为设备复位
+ *       延迟为相对值: 帧到达的主机时刻减去帧内最后一个样本的设备时刻 (展开后的 stamp / tickHz)，
+ *       再减去运行以来的最小值，即排队和发送带来的额外延迟，不含两边时钟的固定偏差
+ *       环形文件: 32 字节文件头 rx_RingHeader_t，之后 capacity 个 32 字节记录 rx_Record_t，均为小端，
+ *       第 i 条记录位于 i % capacity，先写记录再更新 head，其他进程可 mmap 后跟随读取
+ *
+ *       用法: pwmcapture_rx [-b 波特率] [-f csv|json|ring|none] [-o 输出文件] [-r 环形记录数]
+ *                          [-n 记录数] [-t 计时频率Hz] [-i 统计间隔秒] [-g kp,ki,kd] [-p 设定值] 设备|-
+ */
+#define _DEFAULT_SOURCE
+#include "main.h"
+#include "telemetry.h"
+#include "cmdChannel.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "signal.h"
+#include "time.h"
+#include "errno.h"
+#include "fcntl.h"
+#include "poll.h"
+#include "unistd.h"
+#include "termios.h"
+#include "sys/mman.h"
+
+#define RX_BUF_SIZE 65536
+#define RX_RING_MAGIC "TRNG"
+#define RX_RING_DEFAULT 65536
+
+typedef enum
+{
+    RX_FORMAT_CSV,
+    RX_FORMAT_JSON,
+    RX_FORMAT_RING,
+    RX_FORMAT_NONE,
+} rx_Format_t;
+
+typedef struct
+{
+    char magic[4];     // "TRNG"
+    uint32_t recSize;  // sizeof(rx_Record_t)
+    uint32_t capacity; // 记录数
+    uint32_t tickHz;   // 计时频率
+    volatile uint64_t head; // 已写入的记录总数
+    uint64_t reserved;
+} rx_RingHeader_t;
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t stamp;
+    uint32_t period;
+    uint32_t high;
+    float out;         // 以下三项只有采样帧带PID状态时有效
+    float integrator;
+    float measurement;
+    uint8_t type;      // 帧类型 TELEMETRY_FRAME_xxx
+    uint8_t hasPid;
+    uint16_t reserved;
+} rx_Record_t;
+
+typedef struct
+{
+    uint64_t frames, samples, bytes, crcErrors, lost, acks;
+    double latSum, latMax;
+    uint64_t latNum;
+} rx_Stats_t;
+
+typedef struct
+{
+    rx_Format_t format;
+    FILE *out;
+    rx_RingHeader_t *ring;
+    rx_Record_t *ringRec;
+    uint32_t tickHz;
+    uint64_t limit;    // 输出记录数上限，0为不限
+
+    uint64_t records;
+    uint8_t seqValid;  // 批量差分帧 seq 连续性
+    uint32_t lastSeq;
+    uint8_t stampValid; // 设备时间展开
+    uint32_t lastStamp;
+    uint64_t stampHigh;
+    double minOffset;
+    uint8_t offsetValid;
+    rx_Stats_t total, win;
+} rx_State_t;
+
+static volatile sig_atomic_t rx_Stop = 0;
+
+static void rx_Signal(int sig)
+{
+    (void)sig;
+    rx_Stop = 1;
+}
+
+static double rx_Seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rx_Get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float rx_GetFloat(const uint8_t *p)
+{
+    uint32_t v = rx_Get32(p);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+static speed_t rx_Speed(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        default: return B0;
+    }
+}
+
+/* 打开设备，终端设为原始模式并清掉打开前积压的数据 */
+static int rx_Open(const char *path, uint32_t baud)
+{
+    struct termios tio;
+    int fd;
+
+    if (strcmp(path, "-") == 0) return STDIN_FILENO;
+
+    fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) return -1;
+    if (isatty(fd))
+    {
+        tcgetattr(fd, &tio);
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        if (baud != 0)
+        {
+            cfsetispeed(&tio, rx_Speed(baud));
+            cfsetospeed(&tio, rx_Speed(baud));
+        }
+        tcsetattr(fd, TCSANOW, &tio);
+        tcflush(fd, TCIFLUSH);
+    }
+    return fd;
+}
+
+static int rx_OpenRing(rx_State_t *s, const char *path, uint32_t capacity)
+{
+    size_t size = sizeof(rx_RingHeader_t) + (size_t)capacity * sizeof(rx_Record_t);
+    void *map;
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0 || ftruncate(fd, (off_t)size) != 0) return -1;
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    s->ring = (rx_RingHeader_t *)map;
+    s->ringRec = (rx_Record_t *)(s->ring + 1);
+    memcpy(s->ring->magic, RX_RING_MAGIC, 4);
+    s->ring->recSize = sizeof(rx_Record_t);
+    s->ring->capacity = capacity;
+    s->ring->tickHz = s->tickHz;
+    s->ring->head = 0;
+    return 0;
+}
+
+static void rx_Emit(rx_State_t *s, const rx_Record_t *r)
+{
+    double freq = (r->period != 0) ? (double)s->tickHz / (double)r->period : 0;
+    double duty = (r->period != 0) ? (double)r->high * 100.0 / (double)r->period : 0;
+    uint64_t head;
+
+    if (s->limit != 0 && s->records >= s->limit) return;
+    switch (s->format)
+    {
+        case RX_FORMAT_CSV:
+            if (r->hasPid)
+                fprintf(s->out, "%u,%u,%u,%u,%u,%.3f,%.3f,%g,%g,%g\n", r->type, r->seq, r->stamp, r->period, r->high,
+                        freq, duty, r->out, r->integrator, r->measurement);
+            else
+                fprintf(s->out, "%u,%u,%u,%u,%u,%.3f,%.3f,,,\n", r->type, r->seq, r->stamp, r->period, r->high, freq, duty);
+            break;
+
+        case RX_FORMAT_JSON:
+            fprintf(s->out, "{\"type\":%u,\"seq\":%u,\"stamp\":%u,\"period\":%u,\"high\":%u,\"freq\":%.3f,\"duty\":%.3f",
+                    r->type, r->seq, r->stamp, r->period, r->high, freq, duty);
+            if (r->hasPid)
+                fprintf(s->out, ",\"out\":%g,\"integrator\":%g,\"measurement\":%g", r->out, r->integrator, r->measurement);
+            fputs("}\n", s->out);
+            break;
+
+        case RX_FORMAT_RING:
+            head = s->ring->head;
+            s->ringRec[head % s->ring->capacity] = *r;
+            __atomic_store_n(&s->ring->head, head + 1, __ATOMIC_RELEASE);
+            break;
+
+        default:
+            break;
+    }
+
+    s->records++;
+    if (s->limit != 0 && s->records >= s->limit) rx_Stop = 1;
+}
+
+/* 展开32位设备时间戳，返回秒 */
+static double rx_DeviceTime(rx_State_t *s, uint32_t stamp)
+{
+    if (!s->stampValid)
+    {
+        s->stampValid = 1;
+        s->stampHigh = 0;
+    }
+    else if (stamp < s->lastStamp)
+    {
+        s->stampHigh += 1ULL << 32;
+    }
+    s->lastStamp = stamp;
+    return (double)(s->stampHigh + stamp) / (double)s->tickHz;
+}
+
+static void rx_Latency(rx_State_t *s, uint32_t stamp, double arrival)
+{
+    double offset = arrival - rx_DeviceTime(s, stamp), lat;
+
+    if (!s->offsetValid || offset < s->minOffset)
+    {
+        s->minOffset = offset;
+        s->offsetValid = 1;
+    }
+    lat = offset - s->minOffset;
+    s->win.latSum += lat;
+    s->win.latNum++;
+    if (lat > s->win.latMax) s->win.latMax = lat;
+}
+
+static void rx_Sequence(rx_State_t *s, uint32_t seq)
+{
+    if (s->seqValid && seq > s->lastSeq)
+    {
+        s->win.lost += seq - s->lastSeq - 1;
+    }
+    s->lastSeq = seq;
+    s->seqValid = 1;
+}
+
+/* 解码批量差分帧，格式见 telemetry.h */
+static int rx_Batch(rx_State_t *s, const uint8_t *p, uint16_t len, double arrival)
+{
+    rx_Record_t r;
+    uint32_t v[4];
+    uint16_t pos = 1;
+    uint8_t count, i, k, n;
+
+    if (len < 1) return -1;
+    count = p[0];
+    memset(&r, 0, sizeof(r));
+    r.type = TELEMETRY_FRAME_BATCH;
+
+    for (i = 0; i < count; i++)
+    {
+        for (k = 0; k < 4; k++)
+        {
+            n = telemetryCodec_GetVarint(&p[pos], len - pos, &v[k]);
+            if (n == 0) return -1;
+            pos += n;
+        }
+        if (i == 0)
+        {
+            r.seq = v[0];
+            r.stamp = v[1];
+            r.period = v[2];
+            r.high = v[3];
+        }
+        else
+        {
+            r.seq += v[0];
+            r.period += (uint32_t)TELEMETRY_UNZIGZAG(v[2]);
+            r.stamp += (uint32_t)TELEMETRY_UNZIGZAG(v[1]) + r.period;
+            r.high += (uint32_t)TELEMETRY_UNZIGZAG(v[3]);
+        }
+        rx_Sequence(s, r.seq);
+        rx_Emit(s, &r);
+        s->win.samples++;
+    }
+    if (count != 0) rx_Latency(s, r.stamp, arrival);
+    return (pos == len) ? 0 : -1;
+}
+
+/* 处理一帧，in 为两个 0x00 之间的数据，原地解码 */
+static void rx_Frame(rx_State_t *s, uint8_t *in, uint16_t len, double arrival)
+{
+    rx_Record_t r;
+    uint16_t n = telemetryCodec_Unframe(in, len, in);
+
+    if (n == 0)
+    {
+        s->win.crcErrors++;
+        return;
+    }
+    s->win.frames++;
+
+    switch (in[0])
+    {
+        case TELEMETRY_FRAME_SAMPLE:
+            if (n - 1 != TELEMETRY_SAMPLE_LEN_CAP && n - 1 != TELEMETRY_SAMPLE_LEN_PID) break;
+            memset(&r, 0, sizeof(r));
+            r.type = TELEMETRY_FRAME_SAMPLE;
+            r.seq = rx_Get32(&in[1]);
+            r.stamp = rx_Get32(&in[5]);
+            r.period = rx_Get32(&in[9]);
+            r.high = rx_Get32(&in[13]);
+            if (n - 1 == TELEMETRY_SAMPLE_LEN_PID)
+            {
+                r.out = rx_GetFloat(&in[17]);
+                r.integrator = rx_GetFloat(&in[21]);
+                r.measurement = rx_GetFloat(&in[25]);
+                r.hasPid = 1;
+            }
+            rx_Emit(s, &r);
+            break;
+
+        case TELEMETRY_FRAME_BATCH:
+            if (rx_Batch(s, &in[1], n - 1, arrival) != 0) s->win.crcErrors++;
+            break;
+
+        case TELEMETRY_FRAME_ACK:
+            if (n - 1 != 2) break;
+            s->win.acks++;
+            fprintf(stderr, "ack: cmd 0x%02X status %u\n", in[1], in[2]);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void rx_Report(rx_State_t *s, double dt, int final)
+{
+    rx_Stats_t *w = &s->win, *t = &s->total;
+
+    if (!final && dt > 0)
+    {
+        fprintf(stderr, "%.0f frames/s %.0f samples/s %.1f kB/s | lost %llu crc %llu | latency avg %.2f ms max %.2f ms\n",
+                (double)w->frames / dt, (double)w->samples / dt, (double)w->bytes / dt / 1000.0,
+                (unsigned long long)(t->lost + w->lost), (unsigned long long)(t->crcErrors + w->crcErrors),
+                w->latNum ? w->latSum / (double)w->latNum * 1e3 : 0.0, w->latMax * 1e3);
+    }
+
+    t->frames += w->frames;
+    t->samples += w->samples;
+    t->bytes += w->bytes;
+    t->crcErrors += w->crcErrors;
+    t->lost += w->lost;
+    t->acks += w->acks;
+    t->latSum += w->latSum;
+    t->latNum += w->latNum;
+    if (w->latMax > t->latMax) t->latMax = w->latMax;
+    memset(w, 0, sizeof(*w));
+
+    if (final)
+    {
+        fprintf(stderr, "total: %llu bytes, %llu frames, %llu samples, %llu records, %llu lost (%.3f%%), %llu crc errors, %llu acks, latency avg %.2f ms max %.2f ms\n",
+                (unsigned long long)t->bytes, (unsigned long long)t->frames, (unsigned long long)t->samples,
+                (unsigned long long)s->records, (unsigned long long)t->lost,
+                (t->samples + t->lost) ? (double)t->lost * 100.0 / (double)(t->samples + t->lost) : 0.0,
+                (unsigned long long)t->crcErrors, (unsigned long long)t->acks,
+                t->latNum ? t->latSum / (double)t->latNum * 1e3 : 0.0, t->latMax * 1e3);
+    }
+}
+
+static void rx_PutFloat(uint8_t *p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void rx_Send(int fd, uint8_t cmd, const uint8_t *payload, uint8_t len)
+{
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    uint16_t n = telemetryCodec_Frame(cmd, payload, len, frame);
+
+    if (n == 0 || write(fd, frame, n) != (ssize_t)n) perror("send");
+}
+
+static void rx_Usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-b baud] [-f csv|json|ring|none] [-o file] [-r ring records] [-n records]\n"
+                    "       [-t tickHz] [-i interval] [-g kp,ki,kd] [-p setpoint] device|-\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t buf[RX_BUF_SIZE];
+    rx_State_t s;
+    const char *outPath = NULL, *gains = NULL, *setpoint = NULL;
+    uint32_t baud = 115200, ringSize = RX_RING_DEFAULT;
+    double interval = 1.0, now, last;
+    size_t fill = 0, start, i;
+    ssize_t n;
+    struct pollfd pfd;
+    int opt, fd;
+
+    memset(&s, 0, sizeof(s));
+    s.format = RX_FORMAT_CSV;
+    s.tickHz = CAPTURE_TICK_HZ;
+
+    while ((opt = getopt(argc, argv, "b:f:o:r:n:t:i:g:p:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'b': baud = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) s.format = RX_FORMAT_CSV;
+                else if (strcmp(optarg, "json") == 0) s.format = RX_FORMAT_JSON;
+                else if (strcmp(optarg, "ring") == 0) s.format = RX_FORMAT_RING;
+                else if (strcmp(optarg, "none") == 0) s.format = RX_FORMAT_NONE;
+                else { rx_Usage(argv[0]); return 2; }
+                break;
+            case 'o': outPath = optarg; break;
+            case 'r': ringSize = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'n': s.limit = strtoull(optarg, NULL, 0); break;
+            case 't': s.tickHz = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'i': interval = atof(optarg); break;
+            case 'g': gains = optarg; break;
+            case 'p': setpoint = optarg; break;
+            default: rx_Usage(argv[0]); return 2;
+        }
+    }
+    if (optind >= argc || s.tickHz == 0 || ringSize == 0 || (baud != 0 && rx_Speed(baud) == B0))
+    {
+        rx_Usage(argv[0]);
+        return 2;
+    }
+
+    telemetryCodec_Init();
+    fd = rx_Open(argv[optind], baud);
+    if (fd < 0)
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    if (s.format == RX_FORMAT_RING)
+    {
+        if (outPath == NULL || rx_OpenRing(&s, outPath, ringSize) != 0)
+        {
+            fprintf(stderr, "rx: ring output needs a writable -o file\n");
+            return 1;
+        }
+    }
+    else if (s.format != RX_FORMAT_NONE)
+    {
+        s.out = (outPath != NULL) ? fopen(outPath, "w") : stdout;
+        if (s.out == NULL)
+        {
+            perror(outPath);
+            return 1;
+        }
+        setvbuf(s.out, NULL, _IOFBF, 1 << 20);
+        if (s.format == RX_FORMAT_CSV)
+            fputs("type,seq,stamp,period,high,freq,duty,out,integrator,measurement\n", s.out);
+    }
+
+    if (gains != NULL)
+    {
+        float kp, ki, kd;
+        uint8_t p[12];
+        if (sscanf(gains, "%f,%f,%f", &kp, &ki, &kd) != 3)
+        {
+            rx_Usage(argv[0]);
+            return 2;
+        }
+        rx_PutFloat(&p[0], kp);
+        rx_PutFloat(&p[4], ki);
+        rx_PutFloat(&p[8], kd);
+        rx_Send(fd, CMD_CHANNEL_PID_GAINS, p, sizeof(p));
+    }
+    if (setpoint != NULL)
+    {
+        uint8_t p[4];
+        rx_PutFloat(p, (float)atof(setpoint));
+        rx_Send(fd, CMD_CHANNEL_SETPOINT, p, sizeof(p));
+    }
+
+    signal(SIGINT, rx_Signal);
+    signal(SIGTERM, rx_Signal);
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    last = rx_Seconds();
+
+    while (!rx_Stop)
+    {
+        if (poll(&pfd, 1, 200) > 0)
+        {
+            n = read(fd, &buf[fill], sizeof(buf) - fill);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            now = rx_Seconds();
+            s.win.bytes += (uint64_t)n;
+
+            // 新数据中逐个找帧尾，帧在 buf 中原地解码
+            start = 0;
+            for (i = fill; i < fill + (size_t)n && !rx_Stop; i++)
+            {
+                if (buf[i] != 0) continue;
+                if (i - start > TELEMETRY_FRAME_MAX) s.win.crcErrors++;
+                else if (i > start) rx_Frame(&s, &buf[start], (uint16_t)(i - start), now);
+                start = i + 1;
+            }
+            fill += (size_t)n;
+
+            // 剩下的半帧移到开头，超过最大帧长的视为噪声丢弃
+            fill -= start;
+            if (fill > TELEMETRY_FRAME_MAX)
+            {
+                s.win.crcErrors++;
+                fill = 0;
+            }
+            memmove(buf, &buf[start], fill);
+        }
+
+        now = rx_Seconds();
+        if (interval > 0 && now - last >= interval)
+        {
+            rx_Report(&s, now - last, 0);
+            last = now;
+        }
+    }
+
+    rx_Report(&s, 0, 1);
+    if (s.out != NULL && s.out != stdout) fclose(s.out);
+    else if (s.out != NULL) fflush(s.out);
+    if (s.ring != NULL) munmap(s.ring, sizeof(rx_RingHeader_t) + (size_t)s.ring->capacity * sizeof(rx_Record_t));
+    return 0;
+}
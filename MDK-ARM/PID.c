@@ -3,6 +3,43 @@
 #include "string.h"
 #include "math.h"
 
+/* 由增益计算系数，只有乘法 */
+static void PIDController_GainCoef(PIDController_Class_t *pid)
+{
+	pid->cI = 0.5f * pid->Ki * pid->T;
+	pid->cD = 2.0f * pid->Kd * pid->invDen;
+}
+
+/* 采样时间或滤波常数变化时重新计算全部系数 */
+static void PIDController_Coef(PIDController_Class_t *pid)
+{
+	pid->invDen = 1.0f / (2.0f * pid->tau + pid->T);
+	pid->cF = (2.0f * pid->tau - pid->T) * pid->invDen;
+	PIDController_GainCoef(pid);
+}
+
+static void PIDController_Setup(PIDController_Class_t *pid, PIDController_Conf_t *conf)
+{
+	// 赋值
+	pid->Kp = conf->kp;
+	pid->Ki = conf->ki;
+	pid->Kd = conf->kd;
+	pid->tau = conf->tau;
+	pid->limMin = conf->limMin;
+	pid->limMax = conf->limMax;
+	pid->limMinInt = conf->limMinInt;
+	pid->limMaxInt = conf->limMaxInt;
+	pid->T = conf->T;
+	PIDController_Coef(pid);
+
+	// 初始化状态变量
+	pid->integrator = 0.0f;
+	pid->prevError = 0.0f;
+	pid->differentiator = 0.0f;
+	pid->prevMeasurement = 0.0f;
+	pid->out = 0.0f;
+}
+
 void PIDController_Init(PIDController_Handle_t *handle, PIDController_Conf_t *conf)
 {
 	if (handle == NULL || *handle != NULL) 
@@ -16,23 +53,21 @@ void PIDController_Init(PIDController_Handle_t *handle, PIDController_Conf_t *co
 		return;
 	}
 
-	// 赋值
-	(*handle)->Kp = conf->kp;
-	(*handle)->Ki = conf->ki;
-	(*handle)->Kd = conf->kd;
-	(*handle)->tau = conf->tau;
-	(*handle)->limMin = conf->limMin;
-	(*handle)->limMax = conf->limMax;
-	(*handle)->limMinInt = conf->limMinInt;
-	(*handle)->limMaxInt = conf->limMaxInt;
-	(*handle)->T = conf->T;
+	PIDController_Setup(*handle, conf);
+}
 
-	// 初始化状态变量
-	(*handle)->integrator = 0.0f;
-	(*handle)->prevError = 0.0f;
-	(*handle)->differentiator = 0.0f;
-	(*handle)->prevMeasurement = 0.0f;
-	(*handle)->out = 0.0f;
+/* 使用调用者提供的存储初始化，不使用堆 */
+void PIDController_InitStatic(PIDController_Handle_t *handle, PIDController_Class_t *obj, PIDController_Conf_t *conf)
+{
+	if (handle == NULL || *handle != NULL || obj == NULL)
+	{
+		return;
+	}
+
+	memset(obj, 0, sizeof(PIDController_Class_t));
+	*handle = obj;
+
+	PIDController_Setup(*handle, conf);
 }
 
 
@@ -52,7 +87,7 @@ float PIDController_Update(PIDController_Handle_t *handle, float setpoint, float
 	/*
 	 * Integral
 	 */
-	(*handle)->integrator = (*handle)->integrator + 0.5f * (*handle)->Ki * (*handle)->T * (error + (*handle)->prevError);
+	(*handle)->integrator = (*handle)->integrator + (*handle)->cI * (error + (*handle)->prevError);
 
 	/* Anti-wind-up via integrator clamping */
 	if ((*handle)->integrator > (*handle)->limMaxInt)
@@ -70,9 +105,8 @@ float PIDController_Update(PIDController_Handle_t *handle, float setpoint, float
 	 * Derivative (band-limited differentiator)
 	 */
 
-	(*handle)->differentiator = -(2.0f * (*handle)->Kd * (measurement - (*handle)->prevMeasurement) /* Note: derivative on measurement, therefore minus sign in front of equation! */
-								  + (2.0f * (*handle)->tau - (*handle)->T) * (*handle)->differentiator) /
-								(2.0f * (*handle)->tau + (*handle)->T);
+	(*handle)->differentiator = -((*handle)->cD * (measurement - (*handle)->prevMeasurement) /* Note: derivative on measurement, therefore minus sign in front of equation! */
+								  + (*handle)->cF * (*handle)->differentiator);
 
 	/*
 	 * Compute output and apply limits
@@ -97,3 +131,134 @@ float PIDController_Update(PIDController_Handle_t *handle, float setpoint, float
 	/* Return controller output */
 	return (*handle)->out;
 }
+
+/* 修改增益，只重新计算与增益有关的系数，不涉及除法 */
+void PIDController_SetGains(PIDController_Handle_t *handle, float kp, float ki, float kd)
+{
+	if (handle == NULL || *handle == NULL) return;
+	(*handle)->Kp = kp;
+	(*handle)->Ki = ki;
+	(*handle)->Kd = kd;
+	PIDController_GainCoef(*handle);
+}
+
+/* 修改采样时间 单位: 秒 */
+void PIDController_SetSampleTime(PIDController_Handle_t *handle, float T)
+{
+	if (handle == NULL || *handle == NULL) return;
+	(*handle)->T = T;
+	PIDController_Coef(*handle);
+}
+
+
+/*
+ * 定点版本
+ */
+
+/* 浮点系数转为 Q.bits */
+static int32_t PIDController_Q_Coef(float x, uint8_t bits)
+{
+	float v = x * (float)(1L << bits);
+
+	if (v >= 2147483647.0f) return INT32_MAX;
+	if (v <= -2147483648.0f) return INT32_MIN;
+	return (int32_t)(v + ((v >= 0) ? 0.5f : -0.5f));
+}
+
+/* 饱和到32位 */
+static inline pid_q_t PIDController_Q_Sat(int64_t x)
+{
+	if (x > INT32_MAX) return INT32_MAX;
+	if (x < INT32_MIN) return INT32_MIN;
+	return (pid_q_t)x;
+}
+
+/* 信号 * 系数，四舍五入，避免积分项中截断误差单向累积 */
+static inline int64_t PIDController_Q_Mul(pid_q_t x, int32_t coef)
+{
+	return ((int64_t)x * coef + (1LL << (PID_Q_COEF_BITS - 1))) >> PID_Q_COEF_BITS;
+}
+
+void PIDController_Q_Init(PIDController_Q_Handle_t *handle, PIDController_Conf_t *conf)
+{
+	float den;
+
+	if (handle == NULL || *handle != NULL)
+	{
+		return;
+	}
+
+	*handle = calloc(1, sizeof(PIDController_Q_Class_t));
+	if (*handle == NULL)
+	{
+		return;
+	}
+
+	den = 2.0f * conf->tau + conf->T;
+
+	(*handle)->kp = PIDController_Q_Coef(conf->kp, PID_Q_COEF_BITS);
+	(*handle)->ki = PIDController_Q_Coef(0.5f * conf->ki * conf->T, PID_Q_KI_BITS);
+	(*handle)->kd = PIDController_Q_Coef(2.0f * conf->kd / den, PID_Q_COEF_BITS);
+	(*handle)->kf = PIDController_Q_Coef(-(2.0f * conf->tau - conf->T) / den, PID_Q_COEF_BITS); // 与浮点版本的微分项符号一致
+
+	(*handle)->limMin = PID_Q_FROM_FLOAT(conf->limMin);
+	(*handle)->limMax = PID_Q_FROM_FLOAT(conf->limMax);
+	(*handle)->limMinInt = (int64_t)PID_Q_FROM_FLOAT(conf->limMinInt) * ((int64_t)1 << PID_Q_KI_BITS); // 乘法代替负数左移(未定义行为)
+	(*handle)->limMaxInt = (int64_t)PID_Q_FROM_FLOAT(conf->limMaxInt) * ((int64_t)1 << PID_Q_KI_BITS);
+}
+
+pid_q_t PIDController_Q_Update(PIDController_Q_Handle_t *handle, pid_q_t setpoint, pid_q_t measurement)
+{
+	PIDController_Q_Class_t *pid;
+	pid_q_t error, integral;
+	int64_t acc;
+
+	if (handle == NULL || *handle == NULL) return 0;
+	pid = *handle;
+
+	/*
+	 * Error signal
+	 */
+	error = PIDController_Q_Sat((int64_t)setpoint - measurement);
+
+	/*
+	 * Integral with anti-wind-up clamping
+	 */
+	// 64位累加，不舍入，|误差和| < 2^31、|ki| < 2^31，乘积不会溢出
+	acc = pid->integrator + (int64_t)PIDController_Q_Sat((int64_t)error + pid->prevError) * pid->ki;
+	if (acc > pid->limMaxInt)
+	{
+		acc = pid->limMaxInt;
+	}
+	else if (acc < pid->limMinInt)
+	{
+		acc = pid->limMinInt;
+	}
+	pid->integrator = acc;
+	integral = (pid_q_t)((acc + (1LL << (PID_Q_KI_BITS - 1))) >> PID_Q_KI_BITS);
+
+	/*
+	 * Derivative (band-limited differentiator, on measurement)
+	 */
+	pid->differentiator = PIDController_Q_Sat(PIDController_Q_Mul(pid->differentiator, pid->kf)
+											  - PIDController_Q_Mul(PIDController_Q_Sat((int64_t)measurement - pid->prevMeasurement), pid->kd));
+
+	/*
+	 * Compute output and apply limits
+	 */
+	acc = PIDController_Q_Mul(error, pid->kp) + integral + pid->differentiator;
+	if (acc > pid->limMax)
+	{
+		acc = pid->limMax;
+	}
+	else if (acc < pid->limMin)
+	{
+		acc = pid->limMin;
+	}
+	pid->out = (pid_q_t)acc;
+
+	pid->prevError = error;
+	pid->prevMeasurement = measurement;
+
+	return pid->out;
+}
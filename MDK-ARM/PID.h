@@ -1,6 +1,8 @@
 #ifndef PID_CONTROLLER_H
 #define PID_CONTROLLER_H
 
+#include "stdint.h"
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -27,6 +29,12 @@ typedef struct {
     /* 采样时间（单位：秒） */
     float T;  // 控制器的时间步长或采样时间
 
+    /* 由增益和采样时间导出的系数，在 Init/SetGains/SetSampleTime 中计算 */
+    float invDen;  // 1 / (2 * tau + T)
+    float cI;      // 0.5 * Ki * T
+    float cD;      // 2 * Kd / (2 * tau + T)
+    float cF;      // (2 * tau - T) / (2 * tau + T)
+
     /* 控制器的“记忆” */
     float integrator;  // 积分项的当前值
     float prevError;   // 上一个误差，用于计算积分项
@@ -52,10 +60,69 @@ typedef struct{
 
 typedef PIDController_Class_t *PIDController_Handle_t; // pid句柄
 
+/*
+ * 定点版本，用于没有FPU的Cortex-M3
+ * 信号(设定值、测量值、输出、积分/微分状态)为 Q(31-PID_Q_FRAC_BITS).PID_Q_FRAC_BITS，默认 Q15.16
+ * 系数为 Q(31-PID_Q_COEF_BITS).PID_Q_COEF_BITS，默认 Q7.24，增益绝对值需小于 128
+ * 积分系数 0.5*Ki*T 为 Q1.PID_Q_KI_BITS (Q1.30)，绝对值需小于 2，积分项用64位累加，
+ * 小的 Ki*T (如 Ki=0.01，T=0.5ms) 每步的增量也不会被舍入掉
+ * 运算均为饱和运算，系数在初始化时由浮点配置换算，更新中没有除法
+ * 与浮点版本的偏差: 一阶对象阶跃响应(20000 步)中输出误差不超过满量程的 0.005%，
+ * 由 Bench/bench_pidq.c (ctest pid_q_tolerance) 检查，各场景实测值见其输出
+ * 速度: 主机上 (有FPU) 定点版本比浮点慢，F103 上的周期数未测量，相对软件浮点的加速倍数未经验证
+ */
+#ifndef PID_Q_FRAC_BITS
+#define PID_Q_FRAC_BITS 16
+#endif
+
+#ifndef PID_Q_COEF_BITS
+#define PID_Q_COEF_BITS 24
+#endif
+
+#define PID_Q_KI_BITS 30 // 积分系数的小数位数
+
+typedef int32_t pid_q_t; // 定点数
+
+#define PID_Q_FROM_FLOAT(x) ((pid_q_t)((x) * (float)(1L << PID_Q_FRAC_BITS) + (((x) >= 0) ? 0.5f : -0.5f)))
+#define PID_Q_TO_FLOAT(x) ((float)(x) / (float)(1L << PID_Q_FRAC_BITS))
+
+typedef struct {
+
+    /* 系数 Q.PID_Q_COEF_BITS */
+    int32_t kp;       // 比例增益
+    int32_t ki;       // 0.5 * Ki * T，Q1.PID_Q_KI_BITS
+    int32_t kd;       // 2 * Kd / (2 * tau + T)
+    int32_t kf;       // -(2 * tau - T) / (2 * tau + T)
+
+    /* 限制 Q.PID_Q_FRAC_BITS */
+    pid_q_t limMin;
+    pid_q_t limMax;
+    int64_t limMinInt; // Q.(PID_Q_FRAC_BITS + PID_Q_KI_BITS)，与积分项相同
+    int64_t limMaxInt;
+
+    /* 控制器的“记忆” */
+    int64_t integrator; // Q.(PID_Q_FRAC_BITS + PID_Q_KI_BITS)
+    pid_q_t prevError;
+    pid_q_t differentiator;
+    pid_q_t prevMeasurement;
+
+    /* 控制器输出 */
+    pid_q_t out;
+
+} PIDController_Q_Class_t;
+
+typedef PIDController_Q_Class_t *PIDController_Q_Handle_t; // 定点pid句柄
+
 void  PIDController_Init(PIDController_Handle_t *handle,PIDController_Conf_t *conf);
+void  PIDController_InitStatic(PIDController_Handle_t *handle, PIDController_Class_t *obj, PIDController_Conf_t *conf);
 float PIDController_Update(PIDController_Handle_t *handle, float setpoint, float measurement);
+void  PIDController_SetGains(PIDController_Handle_t *handle, float kp, float ki, float kd);
+void  PIDController_SetSampleTime(PIDController_Handle_t *handle, float T);
 
-#ifdef __cpluscplus
+void    PIDController_Q_Init(PIDController_Q_Handle_t *handle, PIDController_Conf_t *conf);
+pid_q_t PIDController_Q_Update(PIDController_Q_Handle_t *handle, pid_q_t setpoint, pid_q_t measurement);
+
+#ifdef __cplusplus
 }
 #endif
 #endif
@@ -0,0 +1,67 @@
+#ifndef PID_CONTROLLER_HPP
+#define PID_CONTROLLER_HPP
+
+/**
+ * @file PID.hpp
+ * @author xfp23
+ * @brief PIDController 的C++封装 (C++11)
+ * @note 控制器存储在对象内部，不使用堆；对象只能移动不能拷贝
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "PID.h"
+#include <stddef.h>
+
+#if __cplusplus >= 201703L
+#define PID_NODISCARD [[nodiscard]]
+#else
+#define PID_NODISCARD
+#endif
+
+class PidController
+{
+public:
+    explicit PidController(const PIDController_Conf_t &conf) : handle_(NULL)
+    {
+        PIDController_Conf_t c = conf;
+        PIDController_InitStatic(&handle_, &obj_, &c);
+    }
+
+    PidController(PidController &&other) : obj_(other.obj_), handle_(NULL)
+    {
+        if (other.handle_ != NULL)
+        {
+            handle_ = &obj_;
+            other.handle_ = NULL;
+        }
+    }
+
+    PidController &operator=(PidController &&other)
+    {
+        if (this != &other)
+        {
+            obj_ = other.obj_;
+            handle_ = (other.handle_ != NULL) ? &obj_ : NULL;
+            other.handle_ = NULL;
+        }
+        return *this;
+    }
+
+    PidController(const PidController &) = delete;
+    PidController &operator=(const PidController &) = delete;
+
+    float update(float setpoint, float measurement) { return PIDController_Update(&handle_, setpoint, measurement); }
+
+    PID_NODISCARD float output() const { return obj_.out; }
+    PID_NODISCARD float integrator() const { return obj_.integrator; }
+
+    /* 需要与C接口混用时取句柄 */
+    PID_NODISCARD PIDController_Handle_t handle() const { return handle_; }
+
+private:
+    PIDController_Class_t obj_;
+    PIDController_Handle_t handle_;
+};
+
+#endif // !PID_CONTROLLER_HPP
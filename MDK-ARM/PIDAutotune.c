@@ -0,0 +1,164 @@
+#include "PIDAutotune.h"
+#include "stdlib.h"
+#include "string.h"
+
+#define PID_AUTOTUNE_PI 3.14159265f
+
+void PIDAutotune_Init(PIDAutotune_Handle_t *handle, PIDAutotune_Conf_t *conf)
+{
+	if (handle == NULL || *handle != NULL || conf == NULL)
+	{
+		return;
+	}
+
+	if (conf->cap == NULL || conf->actuator == NULL || conf->pid == NULL || conf->outHigh <= conf->outLow || conf->cycles == 0)
+	{
+		return;
+	}
+
+	*handle = calloc(1, sizeof(PIDAutotune_Class_t));
+	if (*handle == NULL)
+	{
+		return;
+	}
+
+	memcpy(&(*handle)->conf, conf, sizeof(PIDAutotune_Conf_t));
+	(*handle)->state = PID_AUTOTUNE_IDLE;
+}
+
+/* 开始自整定，记下当前输出后切到高电平 */
+void PIDAutotune_Start(PIDAutotune_Handle_t *handle)
+{
+	PIDAutotune_Class_t *at;
+	pwmActuator_Handle_t act;
+
+	if (handle == NULL || *handle == NULL || *(*handle)->conf.cap == NULL) return;
+	at = *handle;
+	act = *at->conf.actuator;
+
+	// 由最近写入的比较值换算回执行器输入
+	at->restoreOut = (act != NULL) ? act->conf.inMin + (float)act->value / act->scale
+	                               : 0.5f * (at->conf.outHigh + at->conf.outLow);
+
+	at->state = PID_AUTOTUNE_RUNNING;
+	at->relayHigh = 1;
+	at->cycleCount = 0;
+	at->samples = 0;
+	at->lastSeq = (*at->conf.cap)->seq;
+	at->peakMax = -1e30f;
+	at->peakMin = 1e30f;
+	at->periodSum = 0.0f;
+	at->ampSum = 0.0f;
+	pwmActuator_Write(at->conf.actuator, at->conf.outHigh);
+}
+
+/* 由 Ku、Pu 计算增益并写入控制器 */
+static void PIDAutotune_Finish(PIDAutotune_Class_t *at)
+{
+	float n = (float)at->conf.cycles;
+	float d = 0.5f * (at->conf.outHigh - at->conf.outLow);
+	float a = at->ampSum / n;
+	float ti, td;
+
+	at->Pu = at->periodSum / n;
+	at->Ku = (a > 0.0f) ? 4.0f * d / (PID_AUTOTUNE_PI * a) : 0.0f;
+
+	if (at->conf.rule == PID_AUTOTUNE_RULE_TL)
+	{
+		at->Kp = at->Ku / 2.2f;
+		ti = 2.2f * at->Pu;
+		td = at->Pu / 6.3f;
+	}
+	else
+	{
+		at->Kp = 0.6f * at->Ku;
+		ti = 0.5f * at->Pu;
+		td = 0.125f * at->Pu;
+	}
+	at->Ki = (ti > 0.0f) ? at->Kp / ti : 0.0f;
+	at->Kd = at->Kp * td;
+
+	PIDController_SetGains(at->conf.pid, at->Kp, at->Ki, at->Kd);
+	pwmActuator_Write(at->conf.actuator, at->restoreOut);
+	at->state = PID_AUTOTUNE_DONE;
+}
+
+/* 处理一个新样本，在主循环中调用 */
+PIDAutotune_State_t PIDAutotune_Step(PIDAutotune_Handle_t *handle)
+{
+	PIDAutotune_Class_t *at;
+	pwm_Capture_Handle_t cap;
+	uint32_t seq, stamp, primask;
+	float m;
+
+	if (handle == NULL || *handle == NULL) return PID_AUTOTUNE_FAILED;
+	at = *handle;
+	if (at->state != PID_AUTOTUNE_RUNNING) return at->state;
+	cap = *at->conf.cap;
+	if (cap == NULL) return at->state;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	seq = cap->seq;
+	stamp = cap->sampleStamp;
+	switch (at->conf.input)
+	{
+		case PID_LINK_INPUT_FREQ: m = (float)cap->result.freq; break;
+		case PID_LINK_INPUT_PULSE: m = (float)cap->result.pulseWidth; break;
+		default: m = cap->result.duty; break;
+	}
+	__set_PRIMASK(primask);
+
+	if (seq == at->lastSeq) return at->state;
+	at->lastSeq = seq;
+
+	if (++at->samples > at->conf.maxSamples && at->conf.maxSamples != 0)
+	{
+		pwmActuator_Write(at->conf.actuator, at->restoreOut);
+		at->state = PID_AUTOTUNE_FAILED;
+		return at->state;
+	}
+
+	if (m > at->peakMax) at->peakMax = m;
+	if (m < at->peakMin) at->peakMin = m;
+
+	if (at->relayHigh && m > at->conf.setpoint + at->conf.hysteresis)
+	{
+		at->relayHigh = 0;
+		pwmActuator_Write(at->conf.actuator, at->conf.outLow);
+	}
+	else if (!at->relayHigh && m < at->conf.setpoint - at->conf.hysteresis)
+	{
+		/* 低 -> 高 为一个完整振荡周期的起点 */
+		at->relayHigh = 1;
+		pwmActuator_Write(at->conf.actuator, at->conf.outHigh);
+
+		if (at->cycleCount > 0)
+		{
+			at->periodSum += (float)(stamp - at->lastRiseStamp) * cap->tickPeriod;
+			at->ampSum += 0.5f * (at->peakMax - at->peakMin);
+		}
+		at->lastRiseStamp = stamp;
+		at->peakMax = m;
+		at->peakMin = m;
+
+		if (++at->cycleCount > at->conf.cycles)
+		{
+			PIDAutotune_Finish(at);
+		}
+	}
+
+	return at->state;
+}
+
+void PIDAutotune_Delete(PIDAutotune_Handle_t *handle)
+{
+	if (handle == NULL || *handle == NULL) return;
+	// 整定中途删除时同样恢复输出
+	if ((*handle)->state == PID_AUTOTUNE_RUNNING)
+	{
+		pwmActuator_Write((*handle)->conf.actuator, (*handle)->restoreOut);
+	}
+	free(*handle);
+	*handle = NULL;
+}
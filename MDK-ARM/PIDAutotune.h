@@ -0,0 +1,85 @@
+#ifndef PID_AUTOTUNE_H
+#define PID_AUTOTUNE_H
+
+/**
+ * @file PIDAutotune.h
+ * @brief 继电反馈PID自整定
+ * @note 自整定期间执行器按继电方式在 outHigh / outLow 之间切换，由 pwmCapture 测得振荡的周期和幅值，
+ *       算出临界增益 Ku、临界周期 Pu，再按 Ziegler-Nichols 或 Tyreus-Luyben 规则写入控制器增益
+ *       PIDAutotune_Step() 在主循环中调用，每次只处理一个新样本，不阻塞
+ *       结束 (完成或失败) 时执行器恢复为 PIDAutotune_Start() 之前的输出，不会停在继电高/低输出上
+ *       时间取自捕获的上升沿时间戳，捕获需工作在连续模式；假定输出增大时测量值增大
+ */
+#include "pwmCapture.h"
+#include "pwmActuator.h"
+#include "pidLink.h"
+#include "PID.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum {
+	PID_AUTOTUNE_RULE_ZN = 0x00, // Ziegler-Nichols
+	PID_AUTOTUNE_RULE_TL = 0x01, // Tyreus-Luyben，超调更小
+} PIDAutotune_Rule_t;
+
+typedef enum {
+	PID_AUTOTUNE_IDLE = 0x00,    // 未开始
+	PID_AUTOTUNE_RUNNING = 0x01, // 正在振荡测量
+	PID_AUTOTUNE_DONE = 0x02,    // 完成，增益已写入控制器，执行器恢复为开始前的输出
+	PID_AUTOTUNE_FAILED = 0xFF,  // 超过最大样本数仍未完成，执行器恢复为开始前的输出
+} PIDAutotune_State_t;
+
+typedef struct {
+	pwm_Capture_Handle_t *cap;      // 测量
+	pwmActuator_Handle_t *actuator; // 继电输出
+	PIDController_Handle_t *pid;    // 完成后写入增益
+	pidLink_Input_t input;          // 作为测量值的捕获结果
+	PIDAutotune_Rule_t rule;        // 整定规则
+	float setpoint;                 // 继电切换点 (测量值)
+	float hysteresis;               // 切换滞环 (测量值)
+	float outHigh;                  // 继电高输出 (执行器输入)
+	float outLow;                   // 继电低输出 (执行器输入)
+	uint8_t cycles;                 // 参与计算的振荡周期数，第一个周期作为过渡不计入
+	uint32_t maxSamples;            // 最大样本数，超过则失败
+} PIDAutotune_Conf_t;
+
+typedef struct {
+
+	PIDAutotune_Conf_t conf; // 配置
+	PIDAutotune_State_t state;
+
+	/* 继电与振荡测量 */
+	uint8_t relayHigh;       // 当前继电输出为高
+	uint8_t cycleCount;      // 已完成的振荡周期数 (含过渡周期)
+	uint32_t lastSeq;        // 上次处理的捕获序号
+	uint32_t samples;        // 已处理的样本数
+	uint32_t lastRiseStamp;  // 上次切换到高输出时的时间戳
+	float restoreOut;        // 开始前的执行器输入，结束时恢复
+	float peakMax;           // 本周期测量最大值
+	float peakMin;           // 本周期测量最小值
+	float periodSum;         // 周期累加 单位: 秒
+	float ampSum;            // 幅值累加
+
+	/* 结果 */
+	float Ku; // 临界增益
+	float Pu; // 临界周期 单位: 秒
+	float Kp;
+	float Ki;
+	float Kd;
+
+} PIDAutotune_Class_t;
+
+typedef PIDAutotune_Class_t *PIDAutotune_Handle_t; // 自整定句柄
+
+void PIDAutotune_Init(PIDAutotune_Handle_t *handle, PIDAutotune_Conf_t *conf);
+void PIDAutotune_Start(PIDAutotune_Handle_t *handle);
+PIDAutotune_State_t PIDAutotune_Step(PIDAutotune_Handle_t *handle);
+void PIDAutotune_Delete(PIDAutotune_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
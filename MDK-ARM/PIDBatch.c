@@ -0,0 +1,81 @@
+#include "PIDBatch.h"
+#include "stdlib.h"
+#include "string.h"
+
+void PIDBatch_Init(PIDBatch_Handle_t *handle, uint16_t num)
+{
+	if (handle == NULL || *handle != NULL || num == 0 || num > PID_BATCH_MAX)
+	{
+		return;
+	}
+
+	*handle = calloc(1, sizeof(PIDBatch_Class_t));
+	if (*handle == NULL)
+	{
+		return;
+	}
+
+	(*handle)->num = num;
+}
+
+/* 配置第 index 个控制器并清空其状态 */
+void PIDBatch_Set(PIDBatch_Handle_t *handle, uint16_t index, PIDController_Conf_t *conf)
+{
+	PIDBatch_Class_t *b;
+	float invDen;
+
+	if (handle == NULL || *handle == NULL || conf == NULL) return;
+	b = *handle;
+	if (index >= b->num) return;
+
+	invDen = 1.0f / (2.0f * conf->tau + conf->T);
+	b->kp[index] = conf->kp;
+	b->cI[index] = 0.5f * conf->ki * conf->T;
+	b->cD[index] = 2.0f * conf->kd * invDen;
+	b->cF[index] = (2.0f * conf->tau - conf->T) * invDen;
+	b->limMin[index] = conf->limMin;
+	b->limMax[index] = conf->limMax;
+	b->limMinInt[index] = conf->limMinInt;
+	b->limMaxInt[index] = conf->limMaxInt;
+
+	b->integrator[index] = 0.0f;
+	b->prevError[index] = 0.0f;
+	b->differentiator[index] = 0.0f;
+	b->prevMeasurement[index] = 0.0f;
+}
+
+/* 更新全部控制器，setpoint/measurement/out 长度为控制器数量 */
+void PIDBatch_Update(PIDBatch_Handle_t *handle, const float *setpoint, const float *measurement, float *out)
+{
+	PIDBatch_Class_t *b;
+	uint16_t i, n;
+
+	if (handle == NULL || *handle == NULL) return;
+	b = *handle;
+	n = b->num;
+
+	for (i = 0; i < n; i++)
+	{
+		float error = setpoint[i] - measurement[i];
+		float integrator = b->integrator[i] + b->cI[i] * (error + b->prevError[i]);
+		float differentiator;
+		float o;
+
+		/* Anti-wind-up via integrator clamping */
+		if (integrator > b->limMaxInt[i]) integrator = b->limMaxInt[i];
+		else if (integrator < b->limMinInt[i]) integrator = b->limMinInt[i];
+
+		/* Derivative on measurement, same form as PIDController_Update() */
+		differentiator = -(b->cD[i] * (measurement[i] - b->prevMeasurement[i]) + b->cF[i] * b->differentiator[i]);
+
+		o = b->kp[i] * error + integrator + differentiator;
+		if (o > b->limMax[i]) o = b->limMax[i];
+		else if (o < b->limMin[i]) o = b->limMin[i];
+
+		b->integrator[i] = integrator;
+		b->differentiator[i] = differentiator;
+		b->prevError[i] = error;
+		b->prevMeasurement[i] = measurement[i];
+		out[i] = o;
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef PID_BATCH_H
+#define PID_BATCH_H
+
+/**
+ * @file PIDBatch.h
+ * @brief 批量PID，多个控制器的参数和状态按数组(SoA)连续存放
+ * @note 一次调用更新全部控制器，输入输出为数组，算法与 PIDController_Update() 相同
+ *       适合每个捕获通道一个控制器、数量较多的场合
+ */
+#include "PID.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef PID_BATCH_MAX
+#define PID_BATCH_MAX 32 // 最多控制器数量
+#endif
+
+typedef struct {
+
+    uint16_t num; // 控制器数量
+
+    /* 系数 */
+    float kp[PID_BATCH_MAX];
+    float cI[PID_BATCH_MAX]; // 0.5 * Ki * T
+    float cD[PID_BATCH_MAX]; // 2 * Kd / (2 * tau + T)
+    float cF[PID_BATCH_MAX]; // (2 * tau - T) / (2 * tau + T)
+
+    /* 限制 */
+    float limMin[PID_BATCH_MAX];
+    float limMax[PID_BATCH_MAX];
+    float limMinInt[PID_BATCH_MAX];
+    float limMaxInt[PID_BATCH_MAX];
+
+    /* 控制器的“记忆” */
+    float integrator[PID_BATCH_MAX];
+    float prevError[PID_BATCH_MAX];
+    float differentiator[PID_BATCH_MAX];
+    float prevMeasurement[PID_BATCH_MAX];
+
+} PIDBatch_Class_t;
+
+typedef PIDBatch_Class_t *PIDBatch_Handle_t; // 批量pid句柄
+
+void PIDBatch_Init(PIDBatch_Handle_t *handle, uint16_t num);
+void PIDBatch_Set(PIDBatch_Handle_t *handle, uint16_t index, PIDController_Conf_t *conf);
+void PIDBatch_Update(PIDBatch_Handle_t *handle, const float *setpoint, const float *measurement, float *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,110 @@
+#include "PIDCascade.h"
+#include "stdlib.h"
+#include "string.h"
+
+void PIDCascade_Init(PIDCascade_Handle_t *handle, PIDCascade_Conf_t *conf)
+{
+	uint8_t i;
+
+	if (handle == NULL || *handle != NULL || conf == NULL)
+	{
+		return;
+	}
+
+	if (conf->setpoint == NULL || conf->num == 0 || conf->num > PID_CASCADE_MAX_STAGES || conf->T <= 0.0f)
+	{
+		return;
+	}
+
+	for (i = 0; i < conf->num; i++)
+	{
+		if (conf->stage[i].pid == NULL || *conf->stage[i].pid == NULL || conf->stage[i].measurement == NULL || conf->stage[i].divider == 0)
+		{
+			return;
+		}
+	}
+
+	*handle = calloc(1, sizeof(PIDCascade_Class_t));
+	if (*handle == NULL)
+	{
+		return;
+	}
+
+	memcpy(&(*handle)->conf, conf, sizeof(PIDCascade_Conf_t));
+
+	for (i = 0; i < conf->num; i++)
+	{
+		PIDController_SetSampleTime(conf->stage[i].pid, conf->T * (float)conf->stage[i].divider);
+		(*handle)->count[i] = 1; // 第一次调用时全部运行
+	}
+}
+
+/**
+ * @brief 运行一次串级，由外到内依次检查各级是否到期
+ * @note 按 conf.T 周期调用，或通过 PIDCascade_Task 注册到 pidScheduler
+ *
+ * @param handle 句柄
+ */
+void PIDCascade_Run(PIDCascade_Handle_t *handle)
+{
+	PIDCascade_Class_t *c;
+	uint8_t i, num;
+	float setpoint;
+
+	if (handle == NULL || *handle == NULL) return;
+	c = *handle;
+	num = c->conf.num;
+	setpoint = *c->conf.setpoint;
+
+	for (i = 0; i < num; i++)
+	{
+		PIDController_Class_t *pid = *c->conf.stage[i].pid;
+		int8_t block = (i + 1 < num) ? c->sat[i + 1] : 0;
+		float integrator, measurement, out;
+
+		if (--c->count[i] == 0)
+		{
+			c->count[i] = c->conf.stage[i].divider;
+
+			integrator = pid->integrator;
+			measurement = *c->conf.stage[i].measurement;
+			out = PIDController_Update(c->conf.stage[i].pid, setpoint, measurement);
+
+			/* 内环已饱和，撤回向饱和方向的积分
+			 * out 已被限幅，用限幅前的和 (比例 + 撤回后的积分 + 微分) 重新计算后再限幅 */
+			if ((block > 0 && pid->integrator > integrator) || (block < 0 && pid->integrator < integrator))
+			{
+				pid->integrator = integrator;
+				out = pid->Kp * (setpoint - measurement) + integrator + pid->differentiator;
+				if (out > pid->limMax) out = pid->limMax;
+				else if (out < pid->limMin) out = pid->limMin;
+				pid->out = out;
+				c->held++;
+			}
+
+			if (out >= pid->limMax) c->sat[i] = 1;
+			else if (out <= pid->limMin) c->sat[i] = -1;
+			else c->sat[i] = block;
+		}
+
+		setpoint = pid->out;
+	}
+
+	if (c->conf.output != NULL)
+	{
+		*c->conf.output = setpoint;
+	}
+}
+
+/* pidScheduler 任务入口，arg 为 PIDCascade_Handle_t * */
+void PIDCascade_Task(void *arg)
+{
+	PIDCascade_Run((PIDCascade_Handle_t *)arg);
+}
+
+void PIDCascade_Delete(PIDCascade_Handle_t *handle)
+{
+	if (handle == NULL || *handle == NULL) return;
+	free(*handle);
+	*handle = NULL;
+}
@@ -0,0 +1,57 @@
+#ifndef PID_CASCADE_H
+#define PID_CASCADE_H
+
+/**
+ * @file PIDCascade.h
+ * @brief 串级PID，多个控制器由外到内串联，外环输出作为内环设定值
+ * @note 每一级按分频系数运行，例如外环(频率)每10次运行一次、内环(占空比)每次都运行
+ *       各级采样时间 T 由基准周期和分频系数导出，不需要手动填写
+ *       内环输出饱和时，外环向同一方向的积分被撤回(条件积分)，饱和状态逐级向外传递
+ *       约定各级均为正作用: 设定值增大时输出增大
+ *       整条串级作为一个任务注册到 pidScheduler，只占用一个调度槽位
+ */
+#include "PID.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef PID_CASCADE_MAX_STAGES
+#define PID_CASCADE_MAX_STAGES 4 // 最多级数
+#endif
+
+typedef struct {
+	PIDController_Handle_t *pid;  // 控制器句柄
+	volatile float *measurement;  // 本级测量值
+	uint16_t divider;             // 分频系数，每 divider 次调用运行一次，不能为0
+} PIDCascade_Stage_t;
+
+typedef struct {
+	PIDCascade_Stage_t stage[PID_CASCADE_MAX_STAGES]; // stage[0] 为最外环
+	uint8_t num;                  // 级数 1 ~ PID_CASCADE_MAX_STAGES
+	volatile float *setpoint;     // 最外环设定值
+	volatile float *output;       // 最内环输出，可为NULL
+	float T;                      // 调用周期 单位: 秒
+} PIDCascade_Conf_t;
+
+typedef struct {
+
+    PIDCascade_Conf_t conf;
+    uint16_t count[PID_CASCADE_MAX_STAGES]; // 距下次运行的调用次数
+    int8_t sat[PID_CASCADE_MAX_STAGES];     // 饱和方向 1: 上限 -1: 下限 0: 未饱和
+    uint32_t held;                          // 积分被撤回的次数
+
+} PIDCascade_Class_t;
+
+typedef PIDCascade_Class_t *PIDCascade_Handle_t; // 串级句柄
+
+void PIDCascade_Init(PIDCascade_Handle_t *handle, PIDCascade_Conf_t *conf);
+void PIDCascade_Run(PIDCascade_Handle_t *handle);
+void PIDCascade_Task(void *arg);
+void PIDCascade_Delete(PIDCascade_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,116 @@
+#include "PIDGainSched.h"
+#include "stdlib.h"
+#include "string.h"
+
+/* 取出第 seg 段的基值和斜率 */
+static void PIDGainSched_LoadSeg(PIDGainSched_Class_t *gs, uint8_t seg)
+{
+	gs->seg = seg;
+	gs->baseKp = gs->kp[seg];
+	gs->baseKi = gs->ki[seg];
+	gs->baseKd = gs->kd[seg];
+	gs->slopeKp = gs->kp[seg + 1] - gs->kp[seg];
+	gs->slopeKi = gs->ki[seg + 1] - gs->ki[seg];
+	gs->slopeKd = gs->kd[seg + 1] - gs->kd[seg];
+}
+
+/* base + slope * frac，frac 为 Q0.16 */
+static pid_q_t PIDGainSched_Lerp(pid_q_t base, pid_q_t slope, uint32_t frac)
+{
+	return base + (pid_q_t)(((int64_t)slope * (int64_t)frac + (1L << 15)) >> 16);
+}
+
+void PIDGainSched_Init(PIDGainSched_Handle_t *handle, PIDGainSched_Conf_t *conf)
+{
+	uint8_t i;
+
+	if (handle == NULL || *handle != NULL || conf == NULL)
+	{
+		return;
+	}
+
+	if (conf->pid == NULL || conf->table == NULL || conf->step == 0 || conf->num < 2 || conf->num > PID_GAIN_SCHED_MAX_POINTS)
+	{
+		return;
+	}
+
+	*handle = calloc(1, sizeof(PIDGainSched_Class_t));
+	if (*handle == NULL)
+	{
+		return;
+	}
+
+	(*handle)->pid = conf->pid;
+	(*handle)->num = conf->num;
+	(*handle)->xMin = conf->xMin;
+	(*handle)->recip = ((1ULL << 32) + conf->step - 1) / conf->step;
+	(*handle)->span = (uint64_t)(conf->num - 1) * conf->step;
+
+	for (i = 0; i < conf->num; i++)
+	{
+		(*handle)->kp[i] = PID_Q_FROM_FLOAT(conf->table[i].kp);
+		(*handle)->ki[i] = PID_Q_FROM_FLOAT(conf->table[i].ki);
+		(*handle)->kd[i] = PID_Q_FROM_FLOAT(conf->table[i].kd);
+	}
+
+	PIDGainSched_LoadSeg(*handle, 0);
+	(*handle)->pos = UINT32_MAX;
+}
+
+/**
+ * @brief 按调度变量更新控制器增益
+ *
+ * @param handle 句柄
+ * @param x 调度变量，如 pwmCapture_getFreq() 的返回值，超出表格范围时取端点值
+ */
+void PIDGainSched_Update(PIDGainSched_Handle_t *handle, uint32_t x)
+{
+	PIDGainSched_Class_t *gs;
+	uint32_t pos, last, frac;
+	uint64_t dx;
+	uint8_t seg;
+
+	if (handle == NULL || *handle == NULL) return;
+	gs = *handle;
+
+	/* 位置 = (x - xMin) / step，Q.16 */
+	last = (uint32_t)(gs->num - 1) << 16;
+	dx = (x > gs->xMin) ? (uint64_t)(x - gs->xMin) : 0;
+	if (dx >= gs->span)
+	{
+		pos = last;
+	}
+	else
+	{
+		// dx < (num - 1) * step，乘积小于 (num - 1) * 2^32 + dx，不会溢出
+		uint64_t p = (dx * gs->recip) >> 16;
+		pos = (p >= last) ? last : (uint32_t)p;
+	}
+
+	if (pos == gs->pos) return;
+	gs->pos = pos;
+
+	seg = (uint8_t)(pos >> 16);
+	frac = pos & 0xFFFFU;
+	if (seg >= gs->num - 1)
+	{
+		seg = gs->num - 2;
+		frac = 1UL << 16;
+	}
+	if (seg != gs->seg)
+	{
+		PIDGainSched_LoadSeg(gs, seg);
+	}
+
+	PIDController_SetGains(gs->pid,
+		PID_Q_TO_FLOAT(PIDGainSched_Lerp(gs->baseKp, gs->slopeKp, frac)),
+		PID_Q_TO_FLOAT(PIDGainSched_Lerp(gs->baseKi, gs->slopeKi, frac)),
+		PID_Q_TO_FLOAT(PIDGainSched_Lerp(gs->baseKd, gs->slopeKd, frac)));
+}
+
+void PIDGainSched_Delete(PIDGainSched_Handle_t *handle)
+{
+	if (handle == NULL || *handle == NULL) return;
+	free(*handle);
+	*handle = NULL;
+}
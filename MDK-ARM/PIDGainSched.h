@@ -0,0 +1,70 @@
+#ifndef PID_GAIN_SCHED_H
+#define PID_GAIN_SCHED_H
+
+/**
+ * @file PIDGainSched.h
+ * @brief PID增益调度，按调度变量(如捕获频率)查表插值得到 Kp/Ki/Kd
+ * @note 表格断点等间距: x = xMin + i * step，查找为 O(1)，不需要搜索
+ *       表格和插值为定点 Q15.16，每段的基值和斜率只在所在段变化时重新取出
+ *       调度变量未变化时不会写入控制器，写入时调用 PIDController_SetGains()，只有乘法
+ */
+#include "PID.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef PID_GAIN_SCHED_MAX_POINTS
+#define PID_GAIN_SCHED_MAX_POINTS 16 // 最多断点数
+#endif
+
+typedef struct {
+	float kp;
+	float ki;
+	float kd;
+} PIDGainSched_Point_t;
+
+typedef struct {
+	PIDController_Handle_t *pid;       // 被调度的控制器
+	const PIDGainSched_Point_t *table; // 断点增益，长度为 num，增益绝对值需小于 32768
+	uint8_t num;                       // 断点数 2 ~ PID_GAIN_SCHED_MAX_POINTS
+	uint32_t xMin;                     // 第一个断点的调度变量值
+	uint32_t step;                     // 断点间距，不能为0
+} PIDGainSched_Conf_t;
+
+typedef struct {
+
+    PIDController_Handle_t *pid;
+    uint8_t num;
+    uint32_t xMin;
+    uint64_t recip;   // 2^32 / step 向上取整，Q32.32，step 为1时为 2^32
+    uint64_t span;    // (num - 1) * step，超过时取最后一个断点
+
+    /* 表格 Q15.16 */
+    pid_q_t kp[PID_GAIN_SCHED_MAX_POINTS];
+    pid_q_t ki[PID_GAIN_SCHED_MAX_POINTS];
+    pid_q_t kd[PID_GAIN_SCHED_MAX_POINTS];
+
+    /* 当前段缓存 */
+    uint8_t seg;      // 当前段号
+    pid_q_t baseKp;   // 段起点的值
+    pid_q_t baseKi;
+    pid_q_t baseKd;
+    pid_q_t slopeKp;  // 段内增量
+    pid_q_t slopeKi;
+    pid_q_t slopeKd;
+    uint32_t pos;     // 上次的位置 Q.16，未变化则不写入控制器
+
+} PIDGainSched_Class_t;
+
+typedef PIDGainSched_Class_t *PIDGainSched_Handle_t; // 增益调度句柄
+
+void PIDGainSched_Init(PIDGainSched_Handle_t *handle, PIDGainSched_Conf_t *conf);
+void PIDGainSched_Update(PIDGainSched_Handle_t *handle, uint32_t x);
+void PIDGainSched_Delete(PIDGainSched_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
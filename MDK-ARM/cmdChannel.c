@@ -0,0 +1,230 @@
+#include "cmdChannel.h"
+#include "stdlib.h"
+#include "string.h"
+
+/* 小端读取 */
+static float cmdChannel_GetFloat(const uint8_t *p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+/* 执行一条命令，需关中断调用 */
+static cmdChannel_Ack_t cmdChannel_Execute(cmdChannel_Class_t *c, uint8_t cmd, const uint8_t *p, uint16_t len)
+{
+    pwm_Capture_Handle_t *cap = c->conf.cap;
+    PwmCaptureState_t ret;
+
+    switch (cmd)
+    {
+        case CMD_CHANNEL_PING:
+            return (len == 0) ? CMD_CHANNEL_ACK_OK : CMD_CHANNEL_ACK_LENGTH;
+
+        case CMD_CHANNEL_PID_GAINS:
+            if (len != 12) return CMD_CHANNEL_ACK_LENGTH;
+            if (c->conf.pid == NULL || *c->conf.pid == NULL) return CMD_CHANNEL_ACK_FAILED;
+            PIDController_SetGains(c->conf.pid, cmdChannel_GetFloat(&p[0]), cmdChannel_GetFloat(&p[4]), cmdChannel_GetFloat(&p[8]));
+            return CMD_CHANNEL_ACK_OK;
+
+        case CMD_CHANNEL_SETPOINT:
+            if (len != 4) return CMD_CHANNEL_ACK_LENGTH;
+            if (c->conf.setpoint == NULL) return CMD_CHANNEL_ACK_FAILED;
+            *c->conf.setpoint = cmdChannel_GetFloat(p);
+            return CMD_CHANNEL_ACK_OK;
+
+        case CMD_CHANNEL_CAP_START:
+        case CMD_CHANNEL_CAP_STOP:
+        case CMD_CHANNEL_CAP_RESET:
+        case CMD_CHANNEL_CAP_ARM:
+        case CMD_CHANNEL_CAP_DISARM:
+            if (len != 0) return CMD_CHANNEL_ACK_LENGTH;
+            switch (cmd)
+            {
+                case CMD_CHANNEL_CAP_START: ret = pwmCapture_Start(cap); break;
+                case CMD_CHANNEL_CAP_STOP: ret = pwmCapture_Stop(cap); break;
+                case CMD_CHANNEL_CAP_RESET: ret = pwmCapture_Reset(cap); break;
+                case CMD_CHANNEL_CAP_ARM: ret = pwmCapture_Arm(cap); break;
+                default: ret = pwmCapture_Disarm(cap); break;
+            }
+            return (ret == PWM_CAPTURE_OK) ? CMD_CHANNEL_ACK_OK : CMD_CHANNEL_ACK_FAILED;
+
+        case CMD_CHANNEL_CAP_MODE:
+            if (len != 2) return CMD_CHANNEL_ACK_LENGTH;
+            ret = pwmCapture_SetMode(cap, (uint16_t)(p[0] | (p[1] << 8)));
+            return (ret == PWM_CAPTURE_OK) ? CMD_CHANNEL_ACK_OK : CMD_CHANNEL_ACK_FAILED;
+
+        case CMD_CHANNEL_CAP_FILTER:
+            if (len != 1) return CMD_CHANNEL_ACK_LENGTH;
+            ret = pwmCapture_SetFilter(cap, p[0]);
+            return (ret == PWM_CAPTURE_OK) ? CMD_CHANNEL_ACK_OK : CMD_CHANNEL_ACK_FAILED;
+
+        case CMD_CHANNEL_SAVE:
+            // 擦写flash期间停止取指约20ms，不在中断中执行
+            if (len != 0) return CMD_CHANNEL_ACK_LENGTH;
+            if (c->conf.saveRequest == NULL) return CMD_CHANNEL_ACK_FAILED;
+            *c->conf.saveRequest = true;
+            return CMD_CHANNEL_ACK_OK;
+
+        default:
+            return CMD_CHANNEL_ACK_UNKNOWN;
+    }
+}
+
+/* 一帧接收完成，校验后执行并应答 */
+static void cmdChannel_Dispatch(cmdChannel_Class_t *c)
+{
+    uint8_t ack[2];
+    uint16_t n;
+    uint32_t primask;
+
+    n = telemetryCodec_Unframe(c->frame, c->frameLen, c->raw);
+    if (n == 0)
+    {
+        c->errors++;
+        return;
+    }
+    c->commands++;
+
+    // 两次捕获中断之间执行完一条命令
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ack[1] = (uint8_t)cmdChannel_Execute(c, c->raw[0], &c->raw[1], n - 1);
+    __set_PRIMASK(primask);
+
+    ack[0] = c->raw[0];
+    telemetry_Push(c->conf.telemetry, TELEMETRY_FRAME_ACK, ack, sizeof(ack));
+}
+
+/* 按 0x00 分帧 */
+static void cmdChannel_Feed(cmdChannel_Class_t *c, const uint8_t *p, uint16_t len)
+{
+    uint16_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (p[i] == 0)
+        {
+            if (c->overflow)
+            {
+                c->errors++;
+            }
+            else if (c->frameLen != 0)
+            {
+                cmdChannel_Dispatch(c);
+            }
+            c->frameLen = 0;
+            c->overflow = false;
+        }
+        else if (c->frameLen < sizeof(c->frame))
+        {
+            c->frame[c->frameLen++] = p[i];
+        }
+        else
+        {
+            c->overflow = true;
+        }
+    }
+}
+
+/**
+ * @brief 初始化命令通道并开启循环DMA接收
+ *
+ * @param handle 句柄
+ * @param conf 配置
+ * @return CmdChannelState_t 操作日志类型
+ *                      1. CMD_CHANNEL_OK 操作成功
+ *                      2. CMD_CHANNEL_ERROR 操作失败，可能传入了无效地址或接收没有开启
+ *                      3. CMD_CHANNEL_INITIALIZED 传入了一个已经存在的实例
+ */
+CmdChannelState_t cmdChannel_Init(cmdChannel_Handle_t *handle, cmdChannel_conf_t *conf)
+{
+    if (handle == NULL || *handle != NULL)
+    {
+        return CMD_CHANNEL_INITIALIZED;
+    }
+
+    if (conf == NULL || conf->huart == NULL || conf->rxBuf == NULL || conf->rxSize == 0)
+    {
+        return CMD_CHANNEL_ERROR;
+    }
+
+    *handle = calloc(1, sizeof(cmdChannel_Class_t));
+    if (*handle == NULL)
+    {
+        return CMD_CHANNEL_ERROR;
+    }
+
+    memcpy(&(*handle)->conf, conf, sizeof(cmdChannel_conf_t));
+    if (HAL_UARTEx_ReceiveToIdle_DMA(conf->huart, conf->rxBuf, conf->rxSize) != HAL_OK)
+    {
+        free(*handle);
+        *handle = NULL;
+        return CMD_CHANNEL_ERROR;
+    }
+    return CMD_CHANNEL_OK;
+}
+
+/**
+ * @brief 处理新收到的字节
+ * @note 在 HAL_UARTEx_RxEventCallback() 中调用，空闲线、DMA半满和全满时各触发一次
+ *
+ * @param handle 句柄
+ * @param huart 传入 HAL_UARTEx_RxEventCallback() 的形参
+ * @param size 传入 HAL_UARTEx_RxEventCallback() 的形参，DMA在接收缓冲区中写到的位置
+ */
+void cmdChannel_RxEvent(cmdChannel_Handle_t *handle, UART_HandleTypeDef *huart, uint16_t size)
+{
+    cmdChannel_Class_t *c;
+
+    if (handle == NULL || *handle == NULL || huart != (*handle)->conf.huart) return;
+    c = *handle;
+    if (size > c->conf.rxSize) return;
+
+    // DMA已经绕回缓冲区开头
+    if (size < c->rxPos)
+    {
+        cmdChannel_Feed(c, &c->conf.rxBuf[c->rxPos], c->conf.rxSize - c->rxPos);
+        c->rxPos = 0;
+    }
+    cmdChannel_Feed(c, &c->conf.rxBuf[c->rxPos], size - c->rxPos);
+    c->rxPos = (size == c->conf.rxSize) ? 0 : size;
+}
+
+/**
+ * @brief 串口出错（溢出、帧错误等）后HAL会停止接收，在此重新开启
+ * @note 在 HAL_UART_ErrorCallback() 中调用
+ *
+ * @param handle 句柄
+ * @param huart 传入 HAL_UART_ErrorCallback() 的形参
+ */
+void cmdChannel_ErrorCallback(cmdChannel_Handle_t *handle, UART_HandleTypeDef *huart)
+{
+    cmdChannel_Class_t *c;
+
+    if (handle == NULL || *handle == NULL || huart != (*handle)->conf.huart) return;
+    c = *handle;
+    if (huart->RxState != HAL_UART_STATE_READY) return;
+
+    c->rxPos = 0;
+    c->frameLen = 0;
+    c->overflow = false;
+    c->restarts++;
+    HAL_UARTEx_ReceiveToIdle_DMA(huart, c->conf.rxBuf, c->conf.rxSize);
+}
+
+/**
+ * @brief 删除命令通道，停止接收
+ *
+ * @param handle 句柄
+ * @return CmdChannelState_t 操作日志类型
+ */
+CmdChannelState_t cmdChannel_Delete(cmdChannel_Handle_t *handle)
+{
+    if (handle == NULL || *handle == NULL) return CMD_CHANNEL_ERROR;
+    HAL_UART_AbortReceive((*handle)->conf.huart);
+    free(*handle);
+    *handle = NULL;
+    return CMD_CHANNEL_OK;
+}
@@ -0,0 +1,99 @@
+#ifndef CMD_CHANNEL_H
+#define CMD_CHANNEL_H
+
+/**
+ * @file cmdChannel.h
+ * @author xfp23
+ * @brief 串口命令通道，运行中修改捕获模式、滤波和PID参数
+ * @note 串口用循环DMA接收加空闲线检测 (HAL_UARTEx_ReceiveToIdle_DMA)，没有逐字节中断，
+ *       在 HAL_UARTEx_RxEventCallback() 中调用 cmdChannel_RxEvent() 处理新收到的字节
+ *       命令帧与遥测帧格式相同: COBS( cmd | payload | crc32 ) | 0x00，见 telemetryCodec.h
+ *       命令在关中断下执行，捕获中断和控制器更新只会看到修改前或修改后的配置，不会看到一半，
+ *       捕获由硬件锁存，执行期间的边沿不会丢失
+ *       配置了遥测时每条命令回复一个应答帧 TELEMETRY_FRAME_ACK: cmd | status
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+#include "pwmCapture.h"
+#include "PID.h"
+#include "telemetry.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/* 命令，多字节字段为小端 */
+typedef enum
+{
+    CMD_CHANNEL_PING = 0x10,       // 无负载，只回复应答
+    CMD_CHANNEL_PID_GAINS = 0x20,  // float kp, ki, kd
+    CMD_CHANNEL_SETPOINT = 0x21,   // float 设定值
+    CMD_CHANNEL_CAP_START = 0x30,  // 无负载 pwmCapture_Start()
+    CMD_CHANNEL_CAP_STOP = 0x31,   // 无负载 pwmCapture_Stop()
+    CMD_CHANNEL_CAP_RESET = 0x32,  // 无负载 pwmCapture_Reset()
+    CMD_CHANNEL_CAP_ARM = 0x33,    // 无负载 pwmCapture_Arm()
+    CMD_CHANNEL_CAP_DISARM = 0x34, // 无负载 pwmCapture_Disarm()
+    CMD_CHANNEL_CAP_MODE = 0x35,   // uint16_t 捕获模式 PWM_CAPTURE_MODE_xxx，0 连续，n 捕获n个周期后关闭
+    CMD_CHANNEL_CAP_FILTER = 0x36, // uint8_t 输入滤波 0~15
+    CMD_CHANNEL_SAVE = 0x40,       // 无负载 请求把当前配置保存到flash，由主循环执行，见 configStore.h
+} cmdChannel_Cmd_t;
+
+typedef enum
+{
+    CMD_CHANNEL_ACK_OK = 0x00,      // 已执行
+    CMD_CHANNEL_ACK_LENGTH = 0x01,  // 负载长度不对
+    CMD_CHANNEL_ACK_UNKNOWN = 0x02, // 未知命令
+    CMD_CHANNEL_ACK_FAILED = 0x03,  // 执行失败，可能对应的句柄未配置或参数超出范围
+} cmdChannel_Ack_t;
+
+typedef struct
+{
+    UART_HandleTypeDef *huart;      // 串口句柄，需配置循环DMA接收
+    uint8_t *rxBuf;                 // DMA接收缓冲区
+    uint16_t rxSize;                // 接收缓冲区长度
+    pwm_Capture_Handle_t *cap;      // 捕获句柄，可为NULL
+    PIDController_Handle_t *pid;    // 控制器句柄，可为NULL
+    volatile float *setpoint;       // 设定值，可为NULL
+    telemetry_Handle_t *telemetry;  // 发送应答，可为NULL
+    volatile bool *saveRequest;     // 保存请求，CMD_CHANNEL_SAVE 置位，主循环保存后清零，可为NULL
+} cmdChannel_conf_t;
+
+typedef struct
+{
+    cmdChannel_conf_t conf;               // 配置
+    uint16_t rxPos;                       // 已处理到的接收缓冲区位置
+    uint16_t frameLen;                    // 当前帧已收到的长度
+    bool overflow;                        // 当前帧超长，丢弃到下一个帧尾
+    uint8_t frame[TELEMETRY_FRAME_MAX];   // 当前帧 (COBS编码)
+    uint8_t raw[TELEMETRY_FRAME_MAX];     // 解码后的 cmd | payload
+    uint32_t commands;                    // 收到的有效命令数
+    uint32_t errors;                      // 超长、COBS或CRC错误的帧数
+    uint32_t restarts;                    // 串口错误后重新开启接收的次数
+} cmdChannel_Class_t;
+
+typedef cmdChannel_Class_t *cmdChannel_Handle_t; // 命令通道句柄
+
+typedef enum
+{
+    CMD_CHANNEL_OK = 0x00,          // 操作成功
+    CMD_CHANNEL_ERROR = 0xFF,       // 操作失败
+    CMD_CHANNEL_INITIALIZED = 0x01, // 已初始化
+} CmdChannelState_t;
+
+CmdChannelState_t cmdChannel_Init(cmdChannel_Handle_t *handle, cmdChannel_conf_t *conf);
+
+void cmdChannel_RxEvent(cmdChannel_Handle_t *handle, UART_HandleTypeDef *huart, uint16_t size);
+
+void cmdChannel_ErrorCallback(cmdChannel_Handle_t *handle, UART_HandleTypeDef *huart);
+
+CmdChannelState_t cmdChannel_Delete(cmdChannel_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !CMD_CHANNEL_H
@@ -0,0 +1,284 @@
+#include "configStore.h"
+#include "string.h"
+#include "stddef.h"
+
+#define CONFIG_STORE_RECORD_SIZE sizeof(configStore_Record_t)
+#define CONFIG_STORE_CRC_LEN offsetof(configStore_Record_t, crc)
+#define CONFIG_STORE_SLOTS (CONFIG_STORE_PAGE_SIZE / CONFIG_STORE_RECORD_SIZE)
+
+typedef struct
+{
+    uint32_t seq;  // 本页最新有效记录的序号
+    uint16_t slot; // 本页最新有效记录的位置
+    uint16_t free; // 最后一个非空位置之后的位置，等于 CONFIG_STORE_SLOTS 时已满
+    bool valid;    // 本页有有效记录
+} configStore_Page_t;
+
+static const uint32_t configStore_PageAddr[2] = {CONFIG_STORE_PAGE0, CONFIG_STORE_PAGE1};
+
+/**
+ * @brief 读出一个位置的记录，返回是否为空 (全部为 0xFF)
+ *
+ * @param addr 记录地址
+ * @param rec 读出的记录
+ * @return true 空位置
+ * @return false 已写入 (不一定有效)
+ */
+static bool configStore_Read(uint32_t addr, configStore_Record_t *rec)
+{
+    const uint8_t *p = CONFIG_STORE_MEM(addr);
+    uint16_t i;
+
+    memcpy(rec, p, CONFIG_STORE_RECORD_SIZE);
+    for (i = 0; i < CONFIG_STORE_RECORD_SIZE; i++)
+    {
+        if (p[i] != 0xFF)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool configStore_Valid(const configStore_Record_t *rec)
+{
+    return rec->size == sizeof(configStore_Data_t) && rec->version == CONFIG_STORE_VERSION &&
+           rec->crc == telemetryCodec_Crc32((const uint8_t *)rec, CONFIG_STORE_CRC_LEN);
+}
+
+/**
+ * @brief 扫描一页，找出最新的有效记录和可追加的位置
+ * @note 写入中掉电的记录 CRC 错误，跳过；它之前的记录仍然有效，之后从它后面追加
+ */
+static void configStore_Scan(uint8_t page, configStore_Page_t *info)
+{
+    configStore_Record_t rec;
+    uint16_t i;
+
+    memset(info, 0, sizeof(configStore_Page_t));
+    for (i = 0; i < CONFIG_STORE_SLOTS; i++)
+    {
+        if (configStore_Read(configStore_PageAddr[page] + i * CONFIG_STORE_RECORD_SIZE, &rec))
+        {
+            continue;
+        }
+        info->free = i + 1;
+        if (configStore_Valid(&rec) && (!info->valid || rec.seq > info->seq))
+        {
+            info->valid = true;
+            info->seq = rec.seq;
+            info->slot = i;
+        }
+    }
+}
+
+/**
+ * @brief 扫描两页，返回最新记录所在的页，没有有效记录时返回 -1
+ */
+static int8_t configStore_Latest(configStore_Page_t info[2])
+{
+    configStore_Scan(0, &info[0]);
+    configStore_Scan(1, &info[1]);
+
+    if (info[0].valid && (!info[1].valid || info[0].seq > info[1].seq))
+    {
+        return 0;
+    }
+    if (info[1].valid)
+    {
+        return 1;
+    }
+    return -1;
+}
+
+static ConfigStoreState_t configStore_ErasePage(uint8_t page)
+{
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t pageError = 0;
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = FLASH_BANK_1;
+    erase.PageAddress = configStore_PageAddr[page];
+    erase.NbPages = 1;
+    if (HAL_FLASHEx_Erase(&erase, &pageError) != HAL_OK || pageError != 0xFFFFFFFFU)
+    {
+        return CONFIG_STORE_ERROR;
+    }
+    return CONFIG_STORE_OK;
+}
+
+/**
+ * @brief 读取最新的配置
+ * @note 扫描两页一次，取 CRC 正确且 seq 最大的记录；没有有效记录时 data 不修改
+ *
+ * @param data 读出的配置
+ * @return ConfigStoreState_t CONFIG_STORE_OK 已读出 / CONFIG_STORE_EMPTY 没有有效记录
+ */
+ConfigStoreState_t configStore_Load(configStore_Data_t *data)
+{
+    configStore_Page_t info[2];
+    configStore_Record_t rec;
+    int8_t page;
+
+    if (data == NULL)
+    {
+        return CONFIG_STORE_ERROR;
+    }
+
+    telemetryCodec_Init();
+    page = configStore_Latest(info);
+    if (page < 0)
+    {
+        return CONFIG_STORE_EMPTY;
+    }
+
+    configStore_Read(configStore_PageAddr[page] + info[page].slot * CONFIG_STORE_RECORD_SIZE, &rec);
+    memcpy(data, &rec.data, sizeof(configStore_Data_t));
+    return CONFIG_STORE_OK;
+}
+
+/**
+ * @brief 保存配置，追加到最新记录所在页，该页满时擦除另一页写入
+ * @note 擦除和写入期间CPU停顿，约 20ms (擦除) + 2ms (写入)，在启动时或控制空闲时调用
+ *
+ * @param data 要保存的配置
+ * @return ConfigStoreState_t CONFIG_STORE_OK 已写入 / CONFIG_STORE_UNCHANGED 与最新记录相同 / CONFIG_STORE_ERROR 写入失败
+ */
+ConfigStoreState_t configStore_Save(const configStore_Data_t *data)
+{
+    configStore_Page_t info[2];
+    configStore_Record_t rec;
+    const uint16_t *hw = (const uint16_t *)&rec;
+    uint32_t addr;
+    uint16_t i;
+    int8_t page;
+    uint8_t target;
+    ConfigStoreState_t state = CONFIG_STORE_OK;
+
+    if (data == NULL)
+    {
+        return CONFIG_STORE_ERROR;
+    }
+
+    telemetryCodec_Init();
+    page = configStore_Latest(info);
+
+    memset(&rec, 0, sizeof(rec));
+    memcpy(&rec.data, data, sizeof(configStore_Data_t));
+    rec.data.reserved = 0;
+    if (page >= 0)
+    {
+        configStore_Record_t last;
+
+        configStore_Read(configStore_PageAddr[page] + info[page].slot * CONFIG_STORE_RECORD_SIZE, &last);
+        if (memcmp(&last.data, &rec.data, sizeof(configStore_Data_t)) == 0)
+        {
+            return CONFIG_STORE_UNCHANGED;
+        }
+        rec.seq = info[page].seq + 1;
+        target = (uint8_t)page;
+    }
+    else
+    {
+        rec.seq = 1;
+        target = 0;
+    }
+    rec.size = sizeof(configStore_Data_t);
+    rec.version = CONFIG_STORE_VERSION;
+    rec.crc = telemetryCodec_Crc32((const uint8_t *)&rec, CONFIG_STORE_CRC_LEN);
+
+    HAL_FLASH_Unlock();
+    if (page >= 0 && info[target].free >= CONFIG_STORE_SLOTS)
+    {
+        // 当前页已满，擦除另一页，当前页的记录保留到下一次换页
+        target ^= 1;
+        info[target].free = 0;
+        state = configStore_ErasePage(target);
+    }
+    else if (page < 0 && info[target].free != 0)
+    {
+        // 只有无效记录 (旧版本或损坏)，从头开始
+        info[target].free = 0;
+        state = configStore_ErasePage(target);
+    }
+
+    addr = configStore_PageAddr[target] + info[target].free * CONFIG_STORE_RECORD_SIZE;
+    for (i = 0; state == CONFIG_STORE_OK && i < CONFIG_STORE_RECORD_SIZE / 2; i++)
+    {
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, addr + i * 2U, hw[i]) != HAL_OK)
+        {
+            state = CONFIG_STORE_ERROR;
+        }
+    }
+    HAL_FLASH_Lock();
+
+    if (state == CONFIG_STORE_OK && memcmp(CONFIG_STORE_MEM(addr), &rec, CONFIG_STORE_RECORD_SIZE) != 0)
+    {
+        state = CONFIG_STORE_ERROR;
+    }
+    return state;
+}
+
+/**
+ * @brief 擦除两页，之后 configStore_Load() 返回 CONFIG_STORE_EMPTY
+ *
+ * @return ConfigStoreState_t
+ */
+ConfigStoreState_t configStore_Erase(void)
+{
+    ConfigStoreState_t state;
+
+    HAL_FLASH_Unlock();
+    state = configStore_ErasePage(0);
+    if (state == CONFIG_STORE_OK)
+    {
+        state = configStore_ErasePage(1);
+    }
+    HAL_FLASH_Lock();
+    return state;
+}
+
+/**
+ * @brief 从运行中的实例取出当前配置，关中断读取，各项来自同一时刻
+ * @note 只修改 src 中已配置的项，其余保持原值
+ *
+ * @param data 写入的配置
+ * @param src 配置来源
+ */
+void configStore_Snapshot(configStore_Data_t *data, const configStore_Source_t *src)
+{
+    pwm_Capture_Handle_t cap = (src->cap != NULL) ? *src->cap : NULL;
+    pwmActuator_Handle_t act = (src->actuator != NULL) ? *src->actuator : NULL;
+    PIDController_Handle_t pid = (src->pid != NULL) ? *src->pid : NULL;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (cap != NULL)
+    {
+        data->capMode = cap->conf.mode;
+        data->capFilter = pwmCapture_getFilter(cap);
+        data->tickHz = cap->conf.tickHz;
+    }
+    if (act != NULL)
+    {
+        data->actInMin = act->conf.inMin;
+        data->actInMax = act->conf.inMax;
+    }
+    if (pid != NULL)
+    {
+        data->kp = pid->Kp;
+        data->ki = pid->Ki;
+        data->kd = pid->Kd;
+        data->limMin = pid->limMin;
+        data->limMax = pid->limMax;
+        data->limMinInt = pid->limMinInt;
+        data->limMaxInt = pid->limMaxInt;
+        data->tau = pid->tau;
+    }
+    if (src->setpoint != NULL)
+    {
+        data->setpoint = *src->setpoint;
+    }
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,113 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+/**
+ * @file configStore.h
+ * @author xfp23
+ * @brief 配置与校准参数保存在flash最后两页，上电一次读出，不用重新整定和校准
+ * @note 两页轮流使用，每次保存在当前页末尾追加一条记录，不擦除；当前页写满后擦除另一页写入，
+ *       旧页保留到下一次换页，写入或擦除中掉电时仍能读到上一条记录 (写入中掉电由 Bench/bench_config.c 检查)
+ *       记录: seq | size | version | configStore_Data_t | crc32，crc32 与 telemetryCodec_Crc32() 相同，
+ *       读取时扫描两页，取 CRC 正确、长度和版本与当前固件相同、seq 最大的一条
+ *       数据与最新一条相同时不写入；记录64字节，每页16条，每保存32次每页擦除一次
+ *       擦除一页约 20ms，写入每半字约 50us，期间从flash取指停顿，中断也会延迟，不要在控制运行中频繁保存
+ *       F103C8 (64KB) 最后两页为 0x0800F800 / 0x0800FC00，链接时 IROM 需让出这两页
+ *       运行中保存: 命令通道 CMD_CHANNEL_SAVE 或 Modbus 保存寄存器只置位保存请求，
+ *       主循环中用 configStore_Snapshot() 取出当前配置后调用 configStore_Save()，不在中断中擦写flash
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+#include "stdbool.h"
+#include "telemetryCodec.h"
+#include "pwmCapture.h"
+#include "PID.h"
+#include "pwmActuator.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+#ifndef CONFIG_STORE_PAGE0
+#define CONFIG_STORE_PAGE0 0x0800F800UL // 第一页地址
+#endif
+
+#ifndef CONFIG_STORE_PAGE1
+#define CONFIG_STORE_PAGE1 0x0800FC00UL // 第二页地址
+#endif
+
+#ifndef CONFIG_STORE_PAGE_SIZE
+#define CONFIG_STORE_PAGE_SIZE FLASH_PAGE_SIZE
+#endif
+
+#ifndef CONFIG_STORE_MEM
+#define CONFIG_STORE_MEM(addr) ((const uint8_t *)(addr)) // 读flash
+#endif
+
+#define CONFIG_STORE_VERSION 1 // 数据格式版本，configStore_Data_t 改变时加1，旧记录不再读取
+
+typedef struct
+{
+    /* 捕获 */
+    uint16_t capMode;  // 捕获模式 PWM_CAPTURE_MODE_xxx
+    uint8_t capFilter; // 输入滤波 0~15
+    uint8_t reserved;
+    uint32_t tickHz;   // 校准后的捕获计数频率 单位: Hz，修正晶振误差
+
+    /* 执行器标度 */
+    float actInMin;    // 对应占空比 0% 的输入
+    float actInMax;    // 对应占空比 100% 的输入
+
+    /* PID */
+    float kp;
+    float ki;
+    float kd;
+    float limMin;
+    float limMax;
+    float limMinInt;
+    float limMaxInt;
+    float tau;
+    float setpoint;
+} configStore_Data_t; // 长度为4的倍数，无填充
+
+typedef struct
+{
+    uint32_t seq;             // 保存序号，越大越新
+    uint16_t size;            // sizeof(configStore_Data_t)
+    uint16_t version;         // CONFIG_STORE_VERSION
+    configStore_Data_t data;
+    uint32_t crc;             // seq ~ data 的CRC32
+} configStore_Record_t;
+
+typedef struct
+{
+    pwm_Capture_Handle_t *cap;      // 捕获模式、滤波和计数频率，可为NULL
+    pwmActuator_Handle_t *actuator; // 执行器标度，可为NULL
+    PIDController_Handle_t *pid;    // PID增益和限幅，可为NULL
+    volatile float *setpoint;       // 设定值，可为NULL
+} configStore_Source_t; // 运行中的配置来源，为NULL的项保持原值
+
+typedef enum
+{
+    CONFIG_STORE_OK = 0x00,        // 操作成功
+    CONFIG_STORE_ERROR = 0xFF,     // 操作失败，写入或擦除出错
+    CONFIG_STORE_EMPTY = 0x01,     // 没有有效记录
+    CONFIG_STORE_UNCHANGED = 0x02, // 与最新记录相同，未写入
+} ConfigStoreState_t;
+
+ConfigStoreState_t configStore_Load(configStore_Data_t *data);
+
+ConfigStoreState_t configStore_Save(const configStore_Data_t *data);
+
+ConfigStoreState_t configStore_Erase(void);
+
+void configStore_Snapshot(configStore_Data_t *data, const configStore_Source_t *src);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !CONFIG_STORE_H
@@ -0,0 +1,119 @@
+#include "loopLatency.h"
+#include "stdlib.h"
+#include "string.h"
+
+/**
+ * @brief 初始化延迟统计，同时开启DWT周期计数器
+ *
+ * @param handle 句柄
+ * @param conf 配置
+ * @return LoopLatencyState_t 操作日志类型
+ *                      1. LOOP_LATENCY_OK 操作成功
+ *                      2. LOOP_LATENCY_ERROR 操作失败，可能传入了无效地址或区间宽度为0
+ *                      3. LOOP_LATENCY_INITIALIZED 传入了一个已经存在的实例
+ */
+LoopLatencyState_t loopLatency_Init(loopLatency_Handle_t *handle, loopLatency_conf_t *conf)
+{
+    if (handle == NULL || *handle != NULL)
+    {
+        return LOOP_LATENCY_INITIALIZED;
+    }
+
+    if (conf == NULL || conf->binWidth == 0)
+    {
+        return LOOP_LATENCY_ERROR;
+    }
+
+    *handle = calloc(1, sizeof(loopLatency_Class_t));
+    if (*handle == NULL)
+    {
+        return LOOP_LATENCY_ERROR;
+    }
+
+    (*handle)->conf.binWidth = conf->binWidth;
+    (*handle)->min = UINT32_MAX;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    return LOOP_LATENCY_OK;
+}
+
+/**
+ * @brief 记录一次延迟，在比较值写入后立即调用
+ *
+ * @param handle 句柄
+ * @param edgeCycle 样本边沿对应的DWT周期计数 (pwm_Capture_Class_t.sampleCycle)
+ */
+void loopLatency_Commit(loopLatency_Handle_t *handle, uint32_t edgeCycle)
+{
+    uint32_t lat, bin;
+
+    if (handle == NULL || *handle == NULL) return;
+
+    lat = DWT->CYCCNT - edgeCycle;
+    (*handle)->last = lat;
+    if (lat < (*handle)->min) (*handle)->min = lat;
+    if (lat > (*handle)->max) (*handle)->max = lat;
+    (*handle)->sum += lat;
+    (*handle)->count++;
+
+    bin = lat / (*handle)->conf.binWidth;
+    if (bin >= LOOP_LATENCY_BINS)
+    {
+        bin = LOOP_LATENCY_BINS - 1;
+    }
+    (*handle)->hist[bin]++;
+}
+
+/**
+ * @brief 清空统计
+ *
+ * @param handle 句柄
+ */
+void loopLatency_Reset(loopLatency_Handle_t *handle)
+{
+    if (handle == NULL || *handle == NULL) return;
+    (*handle)->last = 0;
+    (*handle)->min = UINT32_MAX;
+    (*handle)->max = 0;
+    (*handle)->count = 0;
+    (*handle)->sum = 0;
+    memset((*handle)->hist, 0, sizeof((*handle)->hist));
+}
+
+/**
+ * @brief 获取平均延迟 单位: CPU周期
+ * @note sum 为64位，与 count 一起在关中断下读取，不会读到中断更新了一半的值
+ *
+ * @param handle
+ * @return uint32_t
+ */
+uint32_t loopLatency_getMean(loopLatency_Handle_t handle)
+{
+    uint64_t sum;
+    uint32_t count, primask;
+
+    if (handle == NULL) return 0;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    sum = handle->sum;
+    count = handle->count;
+    __set_PRIMASK(primask);
+
+    if (count == 0) return 0;
+    return (uint32_t)(sum / count);
+}
+
+/**
+ * @brief 删除延迟统计
+ *
+ * @param handle 句柄
+ * @return LoopLatencyState_t 操作日志类型
+ */
+LoopLatencyState_t loopLatency_Delete(loopLatency_Handle_t *handle)
+{
+    if (handle == NULL || *handle == NULL) return LOOP_LATENCY_ERROR;
+    free(*handle);
+    *handle = NULL;
+    return LOOP_LATENCY_OK;
+}
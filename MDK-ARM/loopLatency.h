@@ -0,0 +1,66 @@
+#ifndef LOOP_LATENCY_H
+#define LOOP_LATENCY_H
+
+/**
+ * @file loopLatency.h
+ * @author xfp23
+ * @brief 闭环延迟统计: 输入边沿 -> 执行器比较值写入
+ * @note 边沿时刻由 pwmCapture 在中断中用DWT周期计数器和定时器计数值还原 (PWM_CAPTURE_TIMESTAMP)，
+ *       写入比较寄存器后调用 loopLatency_Commit() 记录两者之差，单位: CPU周期
+ *       配置到 pidLink 后由其自动调用，每个闭环使用一个实例
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+#ifndef LOOP_LATENCY_BINS
+#define LOOP_LATENCY_BINS 16 // 直方图区间数，最后一个区间包含所有更大的值
+#endif
+
+typedef struct
+{
+    uint32_t binWidth; // 直方图区间宽度 单位: CPU周期
+} loopLatency_conf_t;
+
+typedef struct
+{
+    loopLatency_conf_t conf;           // 配置
+    uint32_t last;                     // 最近一次延迟
+    uint32_t min;                      // 最小延迟
+    uint32_t max;                      // 最大延迟
+    uint32_t count;                    // 样本数
+    uint64_t sum;                      // 延迟总和
+    uint32_t hist[LOOP_LATENCY_BINS];  // 直方图
+} loopLatency_Class_t;
+
+typedef loopLatency_Class_t *loopLatency_Handle_t; // 句柄
+
+typedef enum
+{
+    LOOP_LATENCY_OK = 0x00,          // 操作成功
+    LOOP_LATENCY_ERROR = 0xFF,       // 操作失败
+    LOOP_LATENCY_INITIALIZED = 0x01, // 已初始化
+} LoopLatencyState_t;
+
+LoopLatencyState_t loopLatency_Init(loopLatency_Handle_t *handle, loopLatency_conf_t *conf);
+
+void loopLatency_Commit(loopLatency_Handle_t *handle, uint32_t edgeCycle);
+
+void loopLatency_Reset(loopLatency_Handle_t *handle);
+
+uint32_t loopLatency_getMean(loopLatency_Handle_t handle);
+
+LoopLatencyState_t loopLatency_Delete(loopLatency_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !LOOP_LATENCY_H
@@ -0,0 +1,450 @@
+#include "modbusRtu.h"
+#include "string.h"
+
+/* CRC16 (多项式 0xA001 反转，初值 0xFFFF) 半字节表，比256项的表少占 480 字节 flash */
+static const uint16_t modbusRtu_CrcTable[16] = {
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
+};
+
+static uint32_t modbusRtu_FloatBits(float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    return v;
+}
+
+static float modbusRtu_BitsFloat(uint32_t v)
+{
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+static uint16_t modbusRtu_Get16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void modbusRtu_Put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+/* 读一个输入寄存器，需关中断调用 */
+static uint16_t modbusRtu_Input(modbusRtu_Class_t *c, uint16_t reg)
+{
+    pwm_Capture_Handle_t cap = (c->conf.cap != NULL) ? *c->conf.cap : NULL;
+    PIDController_Handle_t pid = (c->conf.pid != NULL) ? *c->conf.pid : NULL;
+    pidLink_Handle_t link = (c->conf.link != NULL) ? *c->conf.link : NULL;
+    loopLatency_Handle_t lat = (c->conf.latency != NULL) ? *c->conf.latency : NULL;
+    uint32_t v = 0;
+
+    if (reg == 14) return (cap != NULL) ? cap->flag.capSwitch : 0;
+    if (reg == 15) return (cap != NULL) ? cap->conf.mode : 0;
+
+    switch (reg >> 1)
+    {
+        case 0: if (cap != NULL) v = cap->result.freq; break;
+        case 1: if (cap != NULL) v = cap->result.pulseWidth; break;
+        case 2: if (cap != NULL) v = modbusRtu_FloatBits(cap->result.duty); break;
+        case 3: if (cap != NULL) v = modbusRtu_FloatBits(cap->result.period); break;
+        case 4: if (cap != NULL) v = cap->seq; break;
+        case 5: if (cap != NULL) v = cap->samplePeriod; break;
+        case 6: if (cap != NULL) v = cap->sampleStamp; break;
+        case 8: if (pid != NULL) v = modbusRtu_FloatBits(pid->out); break;
+        case 9: if (pid != NULL) v = modbusRtu_FloatBits(pid->integrator); break;
+        case 10: if (pid != NULL) v = modbusRtu_FloatBits(pid->differentiator); break;
+        case 11: if (pid != NULL) v = modbusRtu_FloatBits(pid->prevError); break;
+        case 12: if (pid != NULL) v = modbusRtu_FloatBits(pid->prevMeasurement); break;
+        case 13: if (pid != NULL) v = modbusRtu_FloatBits(pid->T); break;
+        case 16: if (link != NULL) v = link->steps; break;
+        case 17: if (link != NULL) v = link->missed; break;
+        case 18: if (lat != NULL) v = lat->last; break;
+        case 19: if (lat != NULL) v = lat->min; break;
+        case 20: if (lat != NULL) v = lat->max; break;
+        case 21: if (lat != NULL) v = loopLatency_getMean(lat); break;
+        case 22: if (lat != NULL) v = lat->count; break;
+        case 23: v = c->requests; break;
+        case 24: v = c->crcErrors; break;
+        case 25: v = c->exceptions; break;
+        default: break;
+    }
+    return (reg & 1) ? (uint16_t)v : (uint16_t)(v >> 16);
+}
+
+/* 读一个保持寄存器，需关中断调用 */
+static uint16_t modbusRtu_Holding(modbusRtu_Class_t *c, uint16_t reg)
+{
+    pwm_Capture_Handle_t cap = (c->conf.cap != NULL) ? *c->conf.cap : NULL;
+    PIDController_Handle_t pid = (c->conf.pid != NULL) ? *c->conf.pid : NULL;
+    uint32_t v = 0;
+
+    switch (reg)
+    {
+        case 12: return (cap != NULL) ? cap->flag.capSwitch : 0;
+        case 13: return (cap != NULL) ? cap->conf.mode : 0;
+        case 14: return c->filter;
+        case 15: return 0;
+        case 16: return (c->conf.saveRequest != NULL) ? *c->conf.saveRequest : 0;
+        default: break;
+    }
+
+    switch (reg >> 1)
+    {
+        case 0: if (pid != NULL) v = modbusRtu_FloatBits(pid->Kp); break;
+        case 1: if (pid != NULL) v = modbusRtu_FloatBits(pid->Ki); break;
+        case 2: if (pid != NULL) v = modbusRtu_FloatBits(pid->Kd); break;
+        case 3: if (c->conf.setpoint != NULL) v = modbusRtu_FloatBits(*c->conf.setpoint); break;
+        case 4: if (pid != NULL) v = modbusRtu_FloatBits(pid->limMin); break;
+        case 5: if (pid != NULL) v = modbusRtu_FloatBits(pid->limMax); break;
+        default: break;
+    }
+    return (reg & 1) ? (uint16_t)v : (uint16_t)(v >> 16);
+}
+
+/* 检查写入范围和取值，不修改任何状态 */
+static uint8_t modbusRtu_CheckWrite(modbusRtu_Class_t *c, uint16_t start, uint16_t count, const uint8_t *data)
+{
+    uint16_t end = start + count, i, v;
+
+    if (end > MODBUS_RTU_HOLDING_NUM) return MODBUS_RTU_EX_ADDRESS;
+    // 浮点寄存器须成对写入
+    if (start < 12 && (start & 1)) return MODBUS_RTU_EX_ADDRESS;
+    if (end < 12 && (end & 1)) return MODBUS_RTU_EX_ADDRESS;
+
+    for (i = start; i < end; i++)
+    {
+        v = modbusRtu_Get16(&data[(i - start) * 2]);
+        if (i == 6 || i == 7)
+        {
+            if (c->conf.setpoint == NULL) return MODBUS_RTU_EX_FAILURE;
+        }
+        else if (i < 12)
+        {
+            if (c->conf.pid == NULL || *c->conf.pid == NULL) return MODBUS_RTU_EX_FAILURE;
+        }
+        else if (i == 16)
+        {
+            if (c->conf.saveRequest == NULL) return MODBUS_RTU_EX_FAILURE;
+            if (v > 1) return MODBUS_RTU_EX_VALUE;
+        }
+        else
+        {
+            if (c->conf.cap == NULL || *c->conf.cap == NULL) return MODBUS_RTU_EX_FAILURE;
+            if ((i == 12 || i == 15) && v > 1) return MODBUS_RTU_EX_VALUE;
+            if (i == 14 && v > 15) return MODBUS_RTU_EX_VALUE;
+        }
+    }
+    return 0;
+}
+
+/* 写入已检查过的保持寄存器，需关中断调用 */
+static uint8_t modbusRtu_Write(modbusRtu_Class_t *c, uint16_t start, uint16_t count, const uint8_t *data)
+{
+    PIDController_Handle_t pid = (c->conf.pid != NULL) ? *c->conf.pid : NULL;
+    pwm_Capture_Handle_t *cap = c->conf.cap;
+    PwmCaptureState_t ret = PWM_CAPTURE_OK;
+    float gain[3];
+    bool gains = false;
+    uint16_t end = start + count, i, v;
+    uint32_t f;
+
+    if (pid != NULL)
+    {
+        gain[0] = pid->Kp;
+        gain[1] = pid->Ki;
+        gain[2] = pid->Kd;
+    }
+
+    for (i = start; i < end; i++)
+    {
+        v = modbusRtu_Get16(&data[(i - start) * 2]);
+        if (i < 12)
+        {
+            if (i & 1) continue;
+            f = ((uint32_t)v << 16) | modbusRtu_Get16(&data[(i - start) * 2 + 2]);
+            switch (i)
+            {
+                case 0: case 2: case 4: gain[i >> 1] = modbusRtu_BitsFloat(f); gains = true; break;
+                case 6: *c->conf.setpoint = modbusRtu_BitsFloat(f); break;
+                case 8: pid->limMin = modbusRtu_BitsFloat(f); break;
+                default: pid->limMax = modbusRtu_BitsFloat(f); break;
+            }
+            continue;
+        }
+
+        switch (i)
+        {
+            case 12: ret = v ? pwmCapture_Start(cap) : pwmCapture_Stop(cap); break;
+            case 13: ret = pwmCapture_SetMode(cap, v); break;
+            case 14:
+                ret = pwmCapture_SetFilter(cap, (uint8_t)v);
+                if (ret == PWM_CAPTURE_OK) c->filter = (uint8_t)v;
+                break;
+            case 15:
+                if (v == 1)
+                {
+                    ret = pwmCapture_Reset(cap);
+                    loopLatency_Reset(c->conf.latency);
+                }
+                break;
+            default:
+                // 擦写flash期间停止取指约20ms，不在中断中执行
+                if (v == 1) *c->conf.saveRequest = true;
+                break;
+        }
+        if (ret != PWM_CAPTURE_OK) return MODBUS_RTU_EX_FAILURE;
+    }
+
+    if (gains)
+    {
+        PIDController_SetGains(c->conf.pid, gain[0], gain[1], gain[2]);
+    }
+    return 0;
+}
+
+/* 处理一帧，len 不含CRC，返回应答长度 (不含CRC)，0 为不应答 */
+static uint16_t modbusRtu_Process(modbusRtu_Class_t *c, const uint8_t *req, uint16_t len)
+{
+    uint8_t *rsp = c->txBuf;
+    uint8_t func = req[1], ex = 0;
+    uint16_t start, count, i, n = 0;
+    uint32_t primask;
+
+    switch (func)
+    {
+        case 0x03:
+        case 0x04:
+            if (len != 6) return 0;
+            start = modbusRtu_Get16(&req[2]);
+            count = modbusRtu_Get16(&req[4]);
+            if (count == 0 || count > 125) { ex = MODBUS_RTU_EX_VALUE; break; }
+            if ((uint32_t)start + count > ((func == 0x04) ? MODBUS_RTU_INPUT_NUM : MODBUS_RTU_HOLDING_NUM))
+            {
+                ex = MODBUS_RTU_EX_ADDRESS;
+                break;
+            }
+            if (req[0] == 0) return 0;
+
+            rsp[2] = (uint8_t)(count * 2);
+            // 所有寄存器在同一个临界区内写入发送缓冲区，应答中的值来自同一时刻
+            primask = __get_PRIMASK();
+            __disable_irq();
+            for (i = 0; i < count; i++)
+            {
+                modbusRtu_Put16(&rsp[3 + i * 2],
+                                (func == 0x04) ? modbusRtu_Input(c, start + i) : modbusRtu_Holding(c, start + i));
+            }
+            __set_PRIMASK(primask);
+            n = 3 + count * 2;
+            break;
+
+        case 0x06:
+        case 0x10:
+            start = modbusRtu_Get16(&req[2]);
+            if (func == 0x06)
+            {
+                if (len != 6) return 0;
+                count = 1;
+            }
+            else
+            {
+                if (len < 7 || len != 7 + req[6]) return 0;
+                count = modbusRtu_Get16(&req[4]);
+                if (count == 0 || count > 123 || req[6] != count * 2) { ex = MODBUS_RTU_EX_VALUE; break; }
+            }
+            ex = modbusRtu_CheckWrite(c, start, count, &req[(func == 0x06) ? 4 : 7]);
+            if (ex != 0) break;
+
+            primask = __get_PRIMASK();
+            __disable_irq();
+            ex = modbusRtu_Write(c, start, count, &req[(func == 0x06) ? 4 : 7]);
+            __set_PRIMASK(primask);
+            if (ex != 0) break;
+
+            // 应答为请求的前6字节
+            memcpy(&rsp[2], &req[2], 4);
+            n = 6;
+            break;
+
+        default:
+            ex = MODBUS_RTU_EX_FUNCTION;
+            break;
+    }
+
+    if (req[0] == 0) return 0; // 广播不应答
+    rsp[0] = req[0];
+    if (ex != 0)
+    {
+        rsp[1] = func | 0x80;
+        rsp[2] = ex;
+        c->exceptions++;
+        return 3;
+    }
+    rsp[1] = func;
+    return n;
+}
+
+static void modbusRtu_StartRx(modbusRtu_Class_t *c)
+{
+    HAL_UART_AbortReceive(c->conf.huart);
+    HAL_UARTEx_ReceiveToIdle_DMA(c->conf.huart, c->rxBuf, sizeof(c->rxBuf));
+}
+
+/**
+ * @brief 计算 Modbus CRC16，结果低字节在前发送
+ *
+ * @param data 数据
+ * @param len 长度
+ * @return uint16_t CRC，对带CRC的整帧计算结果为0
+ */
+uint16_t modbusRtu_Crc16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--)
+    {
+        crc = modbusRtu_CrcTable[(crc ^ *data) & 0x0F] ^ (crc >> 4);
+        crc = modbusRtu_CrcTable[(crc ^ (*data >> 4)) & 0x0F] ^ (crc >> 4);
+        data++;
+    }
+    return crc;
+}
+
+/**
+ * @brief 使用调用者提供的存储初始化从机并开启DMA接收，不使用堆
+ *
+ * @param handle 句柄
+ * @param obj 实例的存储 (全局或静态变量)，含收发缓冲区约 530 字节
+ * @param conf 配置
+ * @return ModbusRtuState_t 操作日志类型
+ *                      1. MODBUS_RTU_OK 操作成功
+ *                      2. MODBUS_RTU_ERROR 操作失败，可能传入了无效地址、从机地址不在 1~247 或接收没有开启
+ *                      3. MODBUS_RTU_INITIALIZED 传入了一个已经存在的实例
+ */
+ModbusRtuState_t modbusRtu_InitStatic(modbusRtu_Handle_t *handle, modbusRtu_Class_t *obj, modbusRtu_conf_t *conf)
+{
+    if (handle == NULL || *handle != NULL)
+    {
+        return MODBUS_RTU_INITIALIZED;
+    }
+
+    if (obj == NULL || conf == NULL || conf->huart == NULL || conf->address == 0 || conf->address > 247)
+    {
+        return MODBUS_RTU_ERROR;
+    }
+
+    memset(obj, 0, sizeof(modbusRtu_Class_t));
+    memcpy(&obj->conf, conf, sizeof(modbusRtu_conf_t));
+    if (conf->dePort != NULL)
+    {
+        HAL_GPIO_WritePin(conf->dePort, conf->dePin, GPIO_PIN_RESET);
+    }
+    if (HAL_UARTEx_ReceiveToIdle_DMA(conf->huart, obj->rxBuf, sizeof(obj->rxBuf)) != HAL_OK)
+    {
+        return MODBUS_RTU_ERROR;
+    }
+    *handle = obj;
+    return MODBUS_RTU_OK;
+}
+
+/**
+ * @brief 一帧接收完成，解析并发送应答
+ * @note 在 HAL_UARTEx_RxEventCallback() 中调用，只处理空闲线和缓冲区满事件，半满事件忽略
+ *       主站收到应答前不会发下一帧，处理完后接收从缓冲区开头重新开始，每帧都从 rxBuf[0] 开始
+ *
+ * @param handle 句柄
+ * @param huart 传入 HAL_UARTEx_RxEventCallback() 的形参
+ * @param size 传入 HAL_UARTEx_RxEventCallback() 的形参，帧长度
+ */
+void modbusRtu_RxEvent(modbusRtu_Handle_t *handle, UART_HandleTypeDef *huart, uint16_t size)
+{
+    modbusRtu_Class_t *c;
+    uint16_t n = 0, crc;
+
+    if (handle == NULL || *handle == NULL || huart != (*handle)->conf.huart) return;
+    c = *handle;
+    if (HAL_UARTEx_GetRxEventType(huart) == HAL_UART_RXEVENT_HT) return;
+
+    if (size < 4 || size > sizeof(c->rxBuf) || modbusRtu_Crc16(c->rxBuf, size) != 0)
+    {
+        c->crcErrors++;
+    }
+    else if ((c->rxBuf[0] == c->conf.address || c->rxBuf[0] == 0) && !c->busy)
+    {
+        c->requests++;
+        n = modbusRtu_Process(c, c->rxBuf, size - 2);
+    }
+    modbusRtu_StartRx(c);
+
+    if (n == 0) return;
+    crc = modbusRtu_Crc16(c->txBuf, n);
+    c->txBuf[n++] = (uint8_t)crc;
+    c->txBuf[n++] = (uint8_t)(crc >> 8);
+
+    c->busy = true;
+    if (c->conf.dePort != NULL)
+    {
+        HAL_GPIO_WritePin(c->conf.dePort, c->conf.dePin, GPIO_PIN_SET);
+    }
+    if (HAL_UART_Transmit_DMA(huart, c->txBuf, n) != HAL_OK)
+    {
+        modbusRtu_TxCpltCallback(handle, huart);
+    }
+}
+
+/**
+ * @brief 应答发送完成，释放 RS-485 总线
+ * @note 在 HAL_UART_TxCpltCallback() 中调用，此时最后一个字节的停止位已发出
+ *
+ * @param handle 句柄
+ * @param huart 传入 HAL_UART_TxCpltCallback() 的形参
+ */
+void modbusRtu_TxCpltCallback(modbusRtu_Handle_t *handle, UART_HandleTypeDef *huart)
+{
+    modbusRtu_Class_t *c;
+
+    if (handle == NULL || *handle == NULL || huart != (*handle)->conf.huart) return;
+    c = *handle;
+    if (c->conf.dePort != NULL)
+    {
+        HAL_GPIO_WritePin(c->conf.dePort, c->conf.dePin, GPIO_PIN_RESET);
+    }
+    c->busy = false;
+}
+
+/**
+ * @brief 串口出错（溢出、帧错误等）后HAL会停止接收，在此重新开启
+ * @note 在 HAL_UART_ErrorCallback() 中调用
+ *
+ * @param handle 句柄
+ * @param huart 传入 HAL_UART_ErrorCallback() 的形参
+ */
+void modbusRtu_ErrorCallback(modbusRtu_Handle_t *handle, UART_HandleTypeDef *huart)
+{
+    if (handle == NULL || *handle == NULL || huart != (*handle)->conf.huart) return;
+    if (huart->RxState != HAL_UART_STATE_READY) return;
+
+    (*handle)->crcErrors++;
+    HAL_UARTEx_ReceiveToIdle_DMA(huart, (*handle)->rxBuf, sizeof((*handle)->rxBuf));
+}
+
+/**
+ * @brief 删除从机，停止收发，存储由调用者管理
+ *
+ * @param handle 句柄
+ * @return ModbusRtuState_t 操作日志类型
+ */
+ModbusRtuState_t modbusRtu_Delete(modbusRtu_Handle_t *handle)
+{
+    if (handle == NULL || *handle == NULL) return MODBUS_RTU_ERROR;
+    HAL_UART_AbortReceive((*handle)->conf.huart);
+    if ((*handle)->busy)
+    {
+        HAL_UART_AbortTransmit((*handle)->conf.huart);
+    }
+    *handle = NULL;
+    return MODBUS_RTU_OK;
+}
@@ -0,0 +1,108 @@
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+/**
+ * @file modbusRtu.h
+ * @author xfp23
+ * @brief Modbus RTU 从机，经串口 (RS-485) 读取捕获结果、PID状态和统计，修改PID参数和捕获配置
+ * @note 接收用DMA加空闲线检测 (HAL_UARTEx_ReceiveToIdle_DMA)，空闲线即帧尾，请求在DMA接收缓冲区中原地解析，
+ *       应答在关中断下直接从各实例的字段写入DMA发送缓冲区，同一个应答中的寄存器来自同一时刻，没有中间拷贝
+ *       实例由调用者提供存储，不使用堆
+ *       空闲线为1个字符时间，比规范的 3.5 个字符严格，主站帧内字节间隔超过1个字符时会被当作两帧 (CRC错误)
+ *       32位值占两个寄存器，高16位在前；浮点为 IEEE754 单精度，同样高16位在前
+ *       写32位值时两个寄存器须在同一个请求中写入，只写一半返回非法数据地址
+ *
+ *       输入寄存器 (功能码 0x04):
+ *         0 freq u32 Hz          2 pulseWidth u32 计数值    4 duty float %       6 period float 秒
+ *         8 seq u32              10 samplePeriod u32 计数值 12 sampleStamp u32   14 捕获开关 u16   15 捕获模式 u16
+ *         16 PID out float       18 integrator float       20 differentiator float
+ *         22 prevError float     24 prevMeasurement float  26 T float 秒
+ *         32 pidLink steps u32   34 pidLink missed u32
+ *         36 延迟 last u32       38 min u32                40 max u32           42 mean u32      44 count u32 (CPU周期)
+ *         46 请求数 u32          48 CRC错误 u32            50 异常应答 u32
+ *       保持寄存器 (功能码 0x03 / 0x06 / 0x10):
+ *         0 Kp float  2 Ki float  4 Kd float  6 设定值 float  8 limMin float  10 limMax float
+ *         12 捕获开关 u16 (写1开启 0关闭)  13 捕获模式 u16 (0 连续，n 捕获n个周期后关闭)  14 输入滤波 u16 0~15  15 写1复位捕获和延迟统计
+ *         16 写1请求保存配置到flash，由主循环执行 (见 configStore.h)，保存完成前读为1
+ *       未配置的实例读为0，写入返回从机故障
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+#include "pwmCapture.h"
+#include "PID.h"
+#include "pidLink.h"
+#include "loopLatency.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+#define MODBUS_RTU_ADU_MAX 256 // 最大帧长
+
+#define MODBUS_RTU_INPUT_NUM 52   // 输入寄存器个数
+#define MODBUS_RTU_HOLDING_NUM 17 // 保持寄存器个数
+
+typedef enum
+{
+    MODBUS_RTU_EX_FUNCTION = 0x01, // 非法功能码
+    MODBUS_RTU_EX_ADDRESS = 0x02,  // 非法数据地址
+    MODBUS_RTU_EX_VALUE = 0x03,    // 非法数据值
+    MODBUS_RTU_EX_FAILURE = 0x04,  // 从机故障
+} modbusRtu_Exception_t;
+
+typedef struct
+{
+    UART_HandleTypeDef *huart;      // 串口句柄，需配置DMA收发
+    uint8_t address;                // 从机地址 1~247
+    GPIO_TypeDef *dePort;           // RS-485 发送使能引脚，可为NULL (自动收发切换的收发器)
+    uint16_t dePin;
+    pwm_Capture_Handle_t *cap;      // 捕获句柄，可为NULL
+    PIDController_Handle_t *pid;    // 控制器句柄，可为NULL
+    volatile float *setpoint;       // 设定值，可为NULL
+    pidLink_Handle_t *link;         // 可为NULL
+    loopLatency_Handle_t *latency;  // 可为NULL
+    volatile bool *saveRequest;     // 保存请求，写寄存器16置位，主循环保存后清零，可为NULL
+} modbusRtu_conf_t;
+
+typedef struct
+{
+    modbusRtu_conf_t conf;                 // 配置
+    uint8_t rxBuf[MODBUS_RTU_ADU_MAX];     // DMA接收缓冲区，请求在此原地解析
+    uint8_t txBuf[MODBUS_RTU_ADU_MAX];     // DMA发送缓冲区，应答直接写入
+    volatile bool busy;                    // 应答发送中
+    uint8_t filter;                        // 最近写入的输入滤波
+    uint32_t requests;                     // 收到的本机请求数 (含广播)
+    uint32_t crcErrors;                    // 长度或CRC错误的帧数
+    uint32_t exceptions;                   // 异常应答数
+} modbusRtu_Class_t;
+
+typedef modbusRtu_Class_t *modbusRtu_Handle_t; // 句柄
+
+typedef enum
+{
+    MODBUS_RTU_OK = 0x00,          // 操作成功
+    MODBUS_RTU_ERROR = 0xFF,       // 操作失败
+    MODBUS_RTU_INITIALIZED = 0x01, // 已初始化
+} ModbusRtuState_t;
+
+ModbusRtuState_t modbusRtu_InitStatic(modbusRtu_Handle_t *handle, modbusRtu_Class_t *obj, modbusRtu_conf_t *conf);
+
+uint16_t modbusRtu_Crc16(const uint8_t *data, uint16_t len);
+
+void modbusRtu_RxEvent(modbusRtu_Handle_t *handle, UART_HandleTypeDef *huart, uint16_t size);
+
+void modbusRtu_TxCpltCallback(modbusRtu_Handle_t *handle, UART_HandleTypeDef *huart);
+
+void modbusRtu_ErrorCallback(modbusRtu_Handle_t *handle, UART_HandleTypeDef *huart);
+
+ModbusRtuState_t modbusRtu_Delete(modbusRtu_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !MODBUS_RTU_H
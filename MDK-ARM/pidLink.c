@@ -0,0 +1,125 @@
+#include "pidLink.h"
+#include "stdlib.h"
+#include "string.h"
+
+/**
+ * @brief 初始化捕获与控制器的连接
+ *
+ * @param handle 连接句柄
+ * @param conf 配置
+ * @return PidLinkState_t 操作日志类型
+ *                      1. PID_LINK_OK 操作成功
+ *                      2. PID_LINK_ERROR 操作失败，可能传入了无效地址
+ *                      3. PID_LINK_INITIALIZED 传入了一个已经存在的实例
+ */
+PidLinkState_t pidLink_Init(pidLink_Handle_t *handle, pidLink_conf_t *conf)
+{
+    if (handle == NULL || *handle != NULL)
+    {
+        return PID_LINK_INITIALIZED;
+    }
+
+    if (conf == NULL || conf->cap == NULL || conf->pid == NULL || conf->setpoint == NULL)
+    {
+        return PID_LINK_ERROR;
+    }
+
+    *handle = calloc(1, sizeof(pidLink_Class_t));
+    if (*handle == NULL)
+    {
+        return PID_LINK_ERROR;
+    }
+
+    memcpy(&(*handle)->conf, conf, sizeof(pidLink_conf_t));
+    return PID_LINK_OK;
+}
+
+/**
+ * @brief 有新的捕获样本时更新一次控制器
+ *
+ * @param handle 连接句柄
+ * @return bool true : 已更新 false : 没有新样本
+ */
+bool pidLink_Step(pidLink_Handle_t *handle)
+{
+    pwm_Capture_Handle_t cap;
+    uint32_t seq, stamp, dt, diff, primask;
+#if PWM_CAPTURE_TIMESTAMP
+    uint32_t cycle;
+#endif
+    float measurement, out;
+
+    if (handle == NULL || *handle == NULL) return false;
+    cap = *(*handle)->conf.cap;
+    if (cap == NULL) return false;
+
+    // 取样本快照，避免读到一半时被捕获中断更新
+    primask = __get_PRIMASK();
+    __disable_irq();
+    seq = cap->seq;
+    stamp = cap->sampleStamp;
+#if PWM_CAPTURE_TIMESTAMP
+    cycle = cap->sampleCycle;
+#endif
+    switch ((*handle)->conf.input)
+    {
+        case PID_LINK_INPUT_FREQ: measurement = (float)cap->result.freq; break;
+        case PID_LINK_INPUT_PULSE: measurement = (float)cap->result.pulseWidth; break;
+        default: measurement = cap->result.duty; break;
+    }
+    __set_PRIMASK(primask);
+
+    if (seq == (*handle)->lastSeq)
+    {
+        return false;
+    }
+
+    if ((*handle)->started)
+    {
+        (*handle)->missed += seq - (*handle)->lastSeq - 1;
+
+        // 实际采样间隔，相对变化超过阈值时才重新计算系数，只用整数比较
+        dt = stamp - (*handle)->lastStamp;
+        diff = (dt > (*handle)->lastDt) ? dt - (*handle)->lastDt : (*handle)->lastDt - dt;
+        if (dt != 0 && diff > ((*handle)->lastDt >> PID_LINK_DT_SHIFT))
+        {
+            (*handle)->lastDt = dt;
+            PIDController_SetSampleTime((*handle)->conf.pid, (float)dt * cap->tickPeriod);
+        }
+    }
+    (*handle)->started = true;
+    (*handle)->lastSeq = seq;
+    (*handle)->lastStamp = stamp;
+
+    out = PIDController_Update((*handle)->conf.pid, *(*handle)->conf.setpoint, measurement);
+    if ((*handle)->conf.actuator != NULL)
+    {
+        pwmActuator_Write((*handle)->conf.actuator, out);
+    }
+#if PWM_CAPTURE_TIMESTAMP
+    if ((*handle)->conf.latency != NULL)
+    {
+        loopLatency_Commit((*handle)->conf.latency, cycle);
+    }
+#endif
+    if ((*handle)->conf.output != NULL)
+    {
+        *(*handle)->conf.output = out;
+    }
+    (*handle)->steps++;
+    return true;
+}
+
+/**
+ * @brief 删除连接，不影响捕获和控制器
+ *
+ * @param handle 连接句柄
+ * @return PidLinkState_t 操作日志类型
+ */
+PidLinkState_t pidLink_Delete(pidLink_Handle_t *handle)
+{
+    if (handle == NULL || *handle == NULL) return PID_LINK_ERROR;
+    free(*handle);
+    *handle = NULL;
+    return PID_LINK_OK;
+}
@@ -0,0 +1,82 @@
+#ifndef PID_LINK_H
+#define PID_LINK_H
+
+/**
+ * @file pidLink.h
+ * @author xfp23
+ * @brief 由捕获样本驱动的PID更新
+ * @note 把一个 pwmCapture 句柄和一个 PIDController 句柄连接起来，每个新的捕获样本控制器只更新一次，
+ *       采样时间 dt 取两次样本上升沿时间戳之差，而不是固定的 T
+ *       dt 与上次设置的值相差超过 1/2^PID_LINK_DT_SHIFT 时才调用 PIDController_SetSampleTime()，
+ *       输入的 ±1 计数抖动不会在每个样本都重新计算系数 (含一次软件浮点除法)
+ *       时间戳由每个上升沿的周期累加得到，捕获需工作在连续模式，否则关闭期间的周期不会计入 dt
+ *       pidLink_Step() 可以在主循环中轮询，也可以在 HAL_TIM_IC_CaptureCallback() 中紧跟
+ *       pwmCapture_Callback() 调用，后者配合执行器可得到延迟确定的 捕获-控制-输出 闭环
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "pwmCapture.h"
+#include "PID.h"
+#include "pwmActuator.h"
+#include "loopLatency.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+#ifndef PID_LINK_DT_SHIFT
+#define PID_LINK_DT_SHIFT 7 // dt 变化超过 1/128 (约0.8%) 才重新计算系数
+#endif
+
+typedef enum
+{
+    PID_LINK_INPUT_DUTY = 0x00,  // 占空比 单位: %
+    PID_LINK_INPUT_FREQ = 0x01,  // 频率 单位: hz
+    PID_LINK_INPUT_PULSE = 0x02, // 脉宽 单位: 计数值
+} pidLink_Input_t;
+
+typedef struct
+{
+    pwm_Capture_Handle_t *cap;   // 捕获句柄
+    PIDController_Handle_t *pid; // 控制器句柄
+    volatile float *setpoint;    // 设定值
+    volatile float *output;      // 输出，可为NULL
+    pwmActuator_Handle_t *actuator; // 执行器，可为NULL，控制器更新后直接写入比较寄存器
+    loopLatency_Handle_t *latency;  // 延迟统计，可为NULL，执行器写入后记录 边沿->写入 的延迟，需开启 PWM_CAPTURE_TIMESTAMP
+    pidLink_Input_t input;       // 作为测量值的捕获结果
+} pidLink_conf_t;
+
+typedef struct
+{
+    pidLink_conf_t conf;  // 配置
+    uint32_t lastSeq;     // 上次使用的捕获序号
+    uint32_t lastStamp;   // 上次使用的上升沿时间戳
+    uint32_t lastDt;      // 上次设置的采样间隔 单位: 计数值，变化不超过 lastDt >> PID_LINK_DT_SHIFT 时不重新计算系数
+    uint32_t steps;       // 控制器更新次数
+    uint32_t missed;      // 两次更新之间被跳过的样本数
+    bool started;         // 已有第一个样本
+} pidLink_Class_t;
+
+typedef pidLink_Class_t *pidLink_Handle_t; // 句柄
+
+typedef enum
+{
+    PID_LINK_OK = 0x00,          // 操作成功
+    PID_LINK_ERROR = 0xFF,       // 操作失败
+    PID_LINK_INITIALIZED = 0x01, // 已初始化
+} PidLinkState_t;
+
+PidLinkState_t pidLink_Init(pidLink_Handle_t *handle, pidLink_conf_t *conf);
+
+bool pidLink_Step(pidLink_Handle_t *handle);
+
+PidLinkState_t pidLink_Delete(pidLink_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !PID_LINK_H
@@ -0,0 +1,139 @@
+#include "pidScheduler.h"
+
+static pidScheduler_Class_t pidScheduler;
+
+/**
+ * @brief 注册一个按固定周期运行的控制器
+ * @note 控制器的采样时间被设置为 period / PID_SCHEDULER_TICK_HZ 秒
+ *       任务数据写完并经 __DMB() 后才增加注册数量 (volatile)，节拍运行中注册也是安全的
+ *
+ * @param pid 控制器句柄
+ * @param setpoint 设定值地址
+ * @param measurement 测量值地址
+ * @param output 输出地址，不需要时传NULL
+ * @param period 运行周期 单位: 节拍
+ * @return PidSchedulerState_t 操作日志类型
+ *                      1. PID_SCHEDULER_OK 操作成功
+ *                      2. PID_SCHEDULER_ERROR 操作失败，可能传入了无效地址或周期为0
+ *                      3. PID_SCHEDULER_FULL 已达到最大注册数量
+ */
+PidSchedulerState_t pidScheduler_Register(PIDController_Handle_t *pid, volatile float *setpoint, volatile float *measurement, volatile float *output, uint16_t period)
+{
+    pidScheduler_Task_t *task;
+
+    if (pid == NULL || *pid == NULL || setpoint == NULL || measurement == NULL || period == 0)
+    {
+        return PID_SCHEDULER_ERROR;
+    }
+
+    if (pidScheduler.taskNum >= PID_SCHEDULER_MAX_TASKS)
+    {
+        return PID_SCHEDULER_FULL;
+    }
+
+    PIDController_SetSampleTime(pid, (float)period / (float)PID_SCHEDULER_TICK_HZ);
+
+    task = &pidScheduler.task[pidScheduler.taskNum];
+    task->fn = NULL;
+    task->arg = NULL;
+    task->pid = pid;
+    task->setpoint = setpoint;
+    task->measurement = measurement;
+    task->output = output;
+    task->period = period;
+    task->count = period;
+    __DMB(); // 任务数据先于注册数量对节拍中断可见
+    pidScheduler.taskNum++;
+    return PID_SCHEDULER_OK;
+}
+
+/**
+ * @brief 注册一个按固定周期运行的函数任务
+ * @note 函数在节拍中断中调用，采样时间由任务自己管理，如 PIDCascade_Conf_t.T
+ *
+ * @param fn 任务函数
+ * @param arg 任务参数
+ * @param period 运行周期 单位: 节拍
+ * @return PidSchedulerState_t 操作日志类型
+ *                      1. PID_SCHEDULER_OK 操作成功
+ *                      2. PID_SCHEDULER_ERROR 操作失败，可能传入了无效地址或周期为0
+ *                      3. PID_SCHEDULER_FULL 已达到最大注册数量
+ */
+PidSchedulerState_t pidScheduler_RegisterTask(pidScheduler_Fn_t fn, void *arg, uint16_t period)
+{
+    pidScheduler_Task_t *task;
+
+    if (fn == NULL || period == 0)
+    {
+        return PID_SCHEDULER_ERROR;
+    }
+
+    if (pidScheduler.taskNum >= PID_SCHEDULER_MAX_TASKS)
+    {
+        return PID_SCHEDULER_FULL;
+    }
+
+    task = &pidScheduler.task[pidScheduler.taskNum];
+    task->fn = fn;
+    task->arg = arg;
+    task->pid = NULL;
+    task->setpoint = NULL;
+    task->measurement = NULL;
+    task->output = NULL;
+    task->period = period;
+    task->count = period;
+    __DMB(); // 任务数据先于注册数量对节拍中断可见
+    pidScheduler.taskNum++;
+    return PID_SCHEDULER_OK;
+}
+
+/**
+ * @brief 调度节拍
+ * @note 在 SysTick_Handler() 或定时器更新中断中调用
+ */
+void pidScheduler_Tick(void)
+{
+    uint8_t i;
+    float out;
+
+    pidScheduler.ticks++;
+
+    for (i = 0; i < pidScheduler.taskNum; i++)
+    {
+        pidScheduler_Task_t *task = &pidScheduler.task[i];
+
+        if (--task->count != 0)
+        {
+            continue;
+        }
+        task->count = task->period;
+
+        if (task->fn != NULL)
+        {
+            task->fn(task->arg);
+            continue;
+        }
+
+        out = PIDController_Update(task->pid, *task->setpoint, *task->measurement);
+        if (task->output != NULL)
+        {
+            *task->output = out;
+        }
+    }
+
+    // 计算期间下一个节拍已经挂起，说明本次超时
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        pidScheduler.overrun++;
+    }
+}
+
+/**
+ * @brief 获取超时次数
+ *
+ * @return uint32_t
+ */
+uint32_t pidScheduler_getOverrun(void)
+{
+    return pidScheduler.overrun;
+}
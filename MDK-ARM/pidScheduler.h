@@ -0,0 +1,75 @@
+#ifndef PID_SCHEDULER_H
+#define PID_SCHEDULER_H
+
+/**
+ * @file pidScheduler.h
+ * @author xfp23
+ * @brief 定时器驱动的定周期PID调度
+ * @note 在 SysTick_Handler() 中调用 pidScheduler_Tick()，注册的控制器按各自周期在中断中运行
+ *       控制器的采样时间 T 由调度周期导出，不需要手动填写
+ *       一次节拍内的计算没有在下一个节拍到来前完成时记为一次超时
+ *       也可以注册函数任务(如串级PID)，整条串级只占用一个槽位
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+#include "PID.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+#ifndef PID_SCHEDULER_MAX_TASKS
+#define PID_SCHEDULER_MAX_TASKS 4 // 最多注册的控制器数量
+#endif
+
+#ifndef PID_SCHEDULER_TICK_HZ
+#define PID_SCHEDULER_TICK_HZ 1000U // 节拍频率 HAL默认SysTick为1kHz
+#endif
+
+typedef void (*pidScheduler_Fn_t)(void *arg); // 函数任务
+
+typedef struct
+{
+    pidScheduler_Fn_t fn;         // 函数任务，为NULL时运行下面的控制器
+    void *arg;                    // 函数任务参数
+    PIDController_Handle_t *pid;  // 控制器句柄
+    volatile float *setpoint;     // 设定值
+    volatile float *measurement;  // 测量值
+    volatile float *output;       // 输出，可为NULL
+    uint16_t period;              // 运行周期 单位: 节拍
+    uint16_t count;               // 距下次运行的节拍数
+} pidScheduler_Task_t;
+
+typedef struct
+{
+    pidScheduler_Task_t task[PID_SCHEDULER_MAX_TASKS];
+    volatile uint8_t taskNum; // 已注册数量，任务写完后才增加，节拍中断只运行已发布的任务
+    uint32_t ticks;    // 节拍计数
+    uint32_t overrun;  // 超时次数
+} pidScheduler_Class_t;
+
+typedef enum
+{
+    PID_SCHEDULER_OK = 0x00,    // 操作成功
+    PID_SCHEDULER_ERROR = 0xFF, // 操作失败
+    PID_SCHEDULER_FULL = 0x01,  // 已达到最大注册数量
+} PidSchedulerState_t;
+
+PidSchedulerState_t pidScheduler_Register(PIDController_Handle_t *pid, volatile float *setpoint, volatile float *measurement, volatile float *output, uint16_t period);
+
+PidSchedulerState_t pidScheduler_RegisterTask(pidScheduler_Fn_t fn, void *arg, uint16_t period);
+
+void pidScheduler_Tick(void);
+
+uint32_t pidScheduler_getOverrun(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !PID_SCHEDULER_H
@@ -0,0 +1,87 @@
+#include "pwmActuator.h"
+#include "stdlib.h"
+#include "string.h"
+
+/**
+ * @brief 初始化PWM执行器
+ *
+ * @param handle 执行器句柄
+ * @param conf 配置
+ * @return PwmActuatorState_t 操作日志类型
+ *                      1. PWM_ACTUATOR_OK 操作成功
+ *                      2. PWM_ACTUATOR_ERROR 操作失败，可能传入了无效地址或输入范围为空
+ *                      3. PWM_ACTUATOR_INITIALIZED 传入了一个已经存在的实例
+ */
+PwmActuatorState_t pwmActuator_Init(pwmActuator_Handle_t *handle, pwmActuator_conf_t *conf)
+{
+    if (handle == NULL || *handle != NULL)
+    {
+        return PWM_ACTUATOR_INITIALIZED;
+    }
+
+    if (conf == NULL || conf->htim == NULL || (conf->Channel & 3U) != 0 || conf->Channel > TIM_CHANNEL_4 || conf->inMax <= conf->inMin)
+    {
+        return PWM_ACTUATOR_ERROR;
+    }
+
+    *handle = calloc(1, sizeof(pwmActuator_Class_t));
+    if (*handle == NULL)
+    {
+        return PWM_ACTUATOR_ERROR;
+    }
+
+    memcpy(&(*handle)->conf, conf, sizeof(pwmActuator_conf_t));
+
+    // CCR1~CCR4 地址连续
+    (*handle)->ccr = &conf->htim->Instance->CCR1 + (conf->Channel >> 2);
+    (*handle)->ccrMax = __HAL_TIM_GET_AUTORELOAD(conf->htim) + 1;
+    (*handle)->scale = (float)(*handle)->ccrMax / (conf->inMax - conf->inMin);
+    (*handle)->value = *(*handle)->ccr;
+
+    // 比较值预装载，写入在更新事件(周期边界)时生效
+    __HAL_TIM_ENABLE_OCxPRELOAD(conf->htim, conf->Channel);
+    return PWM_ACTUATOR_OK;
+}
+
+/**
+ * @brief 写入控制量
+ * @note 超出输入范围时限幅
+ *
+ * @param handle 执行器句柄
+ * @param value 控制量，范围 inMin ~ inMax
+ */
+void pwmActuator_Write(pwmActuator_Handle_t *handle, float value)
+{
+    float v;
+
+    if (handle == NULL || *handle == NULL) return;
+
+    v = (value - (*handle)->conf.inMin) * (*handle)->scale;
+    if (v <= 0.0f)
+    {
+        (*handle)->value = 0;
+    }
+    else if (v >= (float)(*handle)->ccrMax)
+    {
+        (*handle)->value = (*handle)->ccrMax;
+    }
+    else
+    {
+        (*handle)->value = (uint32_t)v;
+    }
+    *(*handle)->ccr = (*handle)->value;
+}
+
+/**
+ * @brief 删除执行器，不停止PWM输出
+ *
+ * @param handle 执行器句柄
+ * @return PwmActuatorState_t 操作日志类型
+ */
+PwmActuatorState_t pwmActuator_Delete(pwmActuator_Handle_t *handle)
+{
+    if (handle == NULL || *handle == NULL) return PWM_ACTUATOR_ERROR;
+    free(*handle);
+    *handle = NULL;
+    return PWM_ACTUATOR_OK;
+}
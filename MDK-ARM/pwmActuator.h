@@ -0,0 +1,59 @@
+#ifndef PWMACTUATOR_H
+#define PWMACTUATOR_H
+
+/**
+ * @file pwmActuator.h
+ * @author xfp23
+ * @brief PWM输出执行器，把控制器输出映射为定时器比较值
+ * @note 初始化时开启CCR预装载，写入的比较值在下一个周期边界生效，不会产生毛刺
+ *       写入是一次寄存器存储，可在控制器更新后直接调用，PWM输出需已由 HAL_TIM_PWM_Start() 开启
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+#include "stdbool.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+typedef struct
+{
+    TIM_HandleTypeDef *htim; // 定时器句柄
+    uint32_t Channel;        // PWM输出通道 TIM_CHANNEL_1 ~ TIM_CHANNEL_4，其他值初始化失败
+    float inMin;             // 输入下限，对应占空比 0%
+    float inMax;             // 输入上限，对应占空比 100%
+} pwmActuator_conf_t;
+
+typedef struct
+{
+    pwmActuator_conf_t conf;      // 配置
+    volatile uint32_t *ccr;       // 比较寄存器地址
+    uint32_t ccrMax;              // 100% 时的比较值 ARR + 1
+    float scale;                  // (ARR + 1) / (inMax - inMin)
+    uint32_t value;               // 最近一次写入的比较值
+} pwmActuator_Class_t;
+
+typedef pwmActuator_Class_t *pwmActuator_Handle_t; // 执行器句柄
+
+typedef enum
+{
+    PWM_ACTUATOR_OK = 0x00,          // 操作成功
+    PWM_ACTUATOR_ERROR = 0xFF,       // 操作失败
+    PWM_ACTUATOR_INITIALIZED = 0x01, // 已初始化
+} PwmActuatorState_t;
+
+PwmActuatorState_t pwmActuator_Init(pwmActuator_Handle_t *handle, pwmActuator_conf_t *conf);
+
+void pwmActuator_Write(pwmActuator_Handle_t *handle, float value);
+
+PwmActuatorState_t pwmActuator_Delete(pwmActuator_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !PWMACTUATOR_H
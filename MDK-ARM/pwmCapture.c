@@ -11,6 +11,67 @@
 #define OFF (0)
 #endif
 
+/**
+ * @brief 通道对应的 DIER/SR 位 (CCxIE 与 CCxIF 位置相同)
+ */
+static uint32_t pwmCapture_ChannelMask(uint32_t channel)
+{
+    if (channel == TIM_CHANNEL_ALL)
+    {
+        return TIM_IT_CC1 | TIM_IT_CC2 | TIM_IT_CC3 | TIM_IT_CC4;
+    }
+    return TIM_IT_CC1 << (channel >> 2);
+}
+
+/**
+ * @brief 写入配置、建立通道映射并开启捕获
+ *
+ * @param handle 已分配存储的捕获实例
+ * @param conf 配置
+ * @return PwmCaptureState_t 操作日志类型
+ */
+static PwmCaptureState_t pwmCapture_Setup(pwm_Capture_Handle_t handle, pwm_Capture_conf_t *conf)
+{
+    handle->conf.FallChannel = conf->FallChannel;
+    handle->conf.RiseChannel = conf->RiseChannel;
+    handle->conf.htim = conf->htim;
+    handle->conf.tickHz = (conf->tickHz != 0) ? conf->tickHz : PWM_CAPTURE_DEFAULT_TICK_HZ;
+    handle->tickPeriod = 1.0f / (float)handle->conf.tickHz;
+    handle->cyclesPerTick = SystemCoreClock / handle->conf.tickHz;
+    handle->conf.mode = conf->mode;
+    handle->shotsLeft = conf->mode;
+
+    // 处理通道映射
+    switch (handle->conf.FallChannel)
+    {
+        case TIM_CHANNEL_1: handle->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_1; break;
+        case TIM_CHANNEL_2: handle->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_2; break;
+        case TIM_CHANNEL_3: handle->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_3; break;
+        case TIM_CHANNEL_4: handle->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_4; break;
+        case TIM_CHANNEL_ALL: handle->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_CLEARED; break;
+        default: return PWM_CAPTURE_CHANNEL_MISMATCH;
+    }
+
+    switch (handle->conf.RiseChannel)
+    {
+        case TIM_CHANNEL_1: handle->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_1; break;
+        case TIM_CHANNEL_2: handle->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_2; break;
+        case TIM_CHANNEL_3: handle->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_3; break;
+        case TIM_CHANNEL_4: handle->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_4; break;
+        case TIM_CHANNEL_ALL: handle->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_CLEARED; break;
+        default: return PWM_CAPTURE_CHANNEL_MISMATCH;
+    }
+
+    handle->itMask = pwmCapture_ChannelMask(handle->conf.RiseChannel) | pwmCapture_ChannelMask(handle->conf.FallChannel);
+
+    __HAL_TIM_CLEAR_FLAG(handle->conf.htim, TIM_FLAG_CC1);
+    __HAL_TIM_CLEAR_FLAG(handle->conf.htim, TIM_FLAG_CC2);
+    HAL_TIM_IC_Start_IT(handle->conf.htim, handle->conf.RiseChannel);
+    HAL_TIM_IC_Start_IT(handle->conf.htim, handle->conf.FallChannel);
+    handle->flag.capSwitch = true;
+    return PWM_CAPTURE_OK;
+}
+
 /**
  * @brief 初始化pwm输入捕获
  *
@@ -34,37 +95,35 @@ PwmCaptureState_t pwmCapture_Init(pwm_Capture_Handle_t *handle, pwm_Capture_conf
         return PWM_CAPTURE_ERROR;
     }
 
-    (*handle)->conf.FallChannel = conf->FallChannel;
-    (*handle)->conf.RiseChannel = conf->RiseChannel;
-    (*handle)->conf.htim = conf->htim;
+    return pwmCapture_Setup(*handle, conf);
+}
 
-    // 处理通道映射
-    switch ((*handle)->conf.FallChannel)
+/**
+ * @brief 使用调用者提供的存储初始化pwm输入捕获，不使用堆
+ * @note pwmCapture_Delete() 不会释放该存储
+ *
+ * @param handle 输入捕获句柄
+ * @param obj 捕获实例的存储 (全局或静态变量)
+ * @param conf 配置
+ * @return PwmCaptureState_t 操作日志类型 同 pwmCapture_Init()
+ */
+PwmCaptureState_t pwmCapture_InitStatic(pwm_Capture_Handle_t *handle, pwm_Capture_Class_t *obj, pwm_Capture_conf_t *conf)
+{
+    if (handle == NULL || *handle != NULL)
     {
-        case TIM_CHANNEL_1: (*handle)->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_1; break;
-        case TIM_CHANNEL_2: (*handle)->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_2; break;
-        case TIM_CHANNEL_3: (*handle)->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_3; break;
-        case TIM_CHANNEL_4: (*handle)->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_4; break;
-        case TIM_CHANNEL_ALL: (*handle)->channelMap.FallChannel = HAL_TIM_ACTIVE_CHANNEL_CLEARED; break;
-        default: return PWM_CAPTURE_CHANNEL_MISMATCH;
+        return PWM_CAPTURE_INITIALIZED;
     }
 
-    switch ((*handle)->conf.RiseChannel)
+    if (obj == NULL)
     {
-        case TIM_CHANNEL_1: (*handle)->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_1; break;
-        case TIM_CHANNEL_2: (*handle)->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_2; break;
-        case TIM_CHANNEL_3: (*handle)->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_3; break;
-        case TIM_CHANNEL_4: (*handle)->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_4; break;
-        case TIM_CHANNEL_ALL: (*handle)->channelMap.RiseChannel = HAL_TIM_ACTIVE_CHANNEL_CLEARED; break;
-        default: return PWM_CAPTURE_CHANNEL_MISMATCH;
+        return PWM_CAPTURE_ERROR;
     }
 
-    __HAL_TIM_CLEAR_FLAG((*handle)->conf.htim, TIM_FLAG_CC1);
-    __HAL_TIM_CLEAR_FLAG((*handle)->conf.htim, TIM_FLAG_CC2);
-    HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.RiseChannel);
-    HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.FallChannel);
-    (*handle)->flag.capSwitch = true;
-    return PWM_CAPTURE_OK;
+    memset(obj, 0, sizeof(pwm_Capture_Class_t));
+    obj->isStatic = true;
+    *handle = obj;
+
+    return pwmCapture_Setup(*handle, conf);
 }
 
 /**
@@ -90,6 +149,7 @@ void pwmCapture_Callback(pwm_Capture_Handle_t *handle, TIM_HandleTypeDef *htim)
         {
             __HAL_TIM_CLEAR_FLAG((*handle)->conf.htim, TIM_FLAG_CC1);
             (*handle)->CCR.CCR1 = __HAL_TIM_GET_COMPARE((*handle)->conf.htim, (*handle)->conf.RiseChannel);
+            (*handle)->stamp += (*handle)->CCR.CCR1; // 从模式复位，CCR1即上一个上升沿到本上升沿的间隔
         }
     }
 
@@ -106,17 +166,35 @@ void pwmCapture_Callback(pwm_Capture_Handle_t *handle, TIM_HandleTypeDef *htim)
 
         /** 开始计算 */
         // 周期
-        (*handle)->result.period = (float)(*handle)->CCR.CCR1 * 1E-6;
+        (*handle)->result.period = (float)(*handle)->CCR.CCR1 * (*handle)->tickPeriod;
 
         // 占空比
         (*handle)->result.duty = ((float)(*handle)->CCR.CCR2 / (float)(*handle)->CCR.CCR1) * 100;
         (*handle)->result.pulseWidth = (*handle)->CCR.CCR2;
 
         // 频率
-        (*handle)->result.freq = 1.00 / ((*handle)->result.period);
+        (*handle)->result.freq = ((*handle)->CCR.CCR1 != 0) ? (*handle)->conf.tickHz / (*handle)->CCR.CCR1 : 0;
 
+#if PWM_CAPTURE_TIMESTAMP
+        // 从模式复位: 计数值为距最近上升沿的计数，若由下降沿完成则减去下降沿的捕获值
+        {
+            uint32_t cnt = __HAL_TIM_GET_COUNTER(htim);
+            uint32_t edge = (htim->Channel == (*handle)->channelMap.FallChannel) ? (*handle)->CCR.CCR2 : 0;
+            (*handle)->sampleCycle = DWT->CYCCNT - (cnt - edge) * (*handle)->cyclesPerTick;
+        }
+#endif
+        (*handle)->sampleStamp = (*handle)->stamp;
+        (*handle)->samplePeriod = (*handle)->CCR.CCR1;
+        (*handle)->seq++;
         (*handle)->flag.isCapComplete = ON;
         memset(&(*handle)->CCR, 0, sizeof(pwm_Capture_Int_t));
+
+        // 单次/N次模式 捕获够次数后关闭本实例的中断
+        if ((*handle)->conf.mode != PWM_CAPTURE_MODE_CONTINUOUS && --(*handle)->shotsLeft == 0)
+        {
+            htim->Instance->DIER &= ~(*handle)->itMask;
+            (*handle)->flag.capSwitch = false;
+        }
     }
 }
 
@@ -142,20 +220,31 @@ PwmCaptureState_t pwmCapture_Stop(pwm_Capture_Handle_t *handle)
 
 /**
  * @brief 开启pwm捕获
+ * @note 单次/N次模式自动关闭或 pwmCapture_Disarm() 之后也可调用，重新装载捕获次数
  * 
  * @param handle
  * @return PwmCaptureState_t 操作日志类型 
  *                      1. PWM_CAPTURE_OK 操作成功  
- *                      2. PWM_CAPTURE_ERROR 操作失败，可能传入了无效地址
+ *                      2. PWM_CAPTURE_ERROR 操作失败，可能传入了无效地址或HAL开启通道失败
  */
 PwmCaptureState_t pwmCapture_Start(pwm_Capture_Handle_t *handle)
 {
     if (handle == NULL || *handle == NULL) return PWM_CAPTURE_ERROR;
+    // 自动关闭或 Disarm 只清除CCxIE，HAL通道状态仍为BUSY，HAL_TIM_IC_Start_IT 会直接返回错误，先停止使其回到READY
+    HAL_TIM_IC_Stop_IT((*handle)->conf.htim, (*handle)->conf.RiseChannel);
+    HAL_TIM_IC_Stop_IT((*handle)->conf.htim, (*handle)->conf.FallChannel);
     __HAL_TIM_CLEAR_FLAG((*handle)->conf.htim, TIM_FLAG_CC1);
     __HAL_TIM_CLEAR_FLAG((*handle)->conf.htim, TIM_FLAG_CC2);
-    HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.RiseChannel);
-    HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.FallChannel);
+    (*handle)->flag.isRiseEdge = OFF;
+    (*handle)->flag.isFallEdge = OFF;
+    (*handle)->shotsLeft = (*handle)->conf.mode;
     (*handle)->flag.capSwitch = true;
+    if (HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.RiseChannel) != HAL_OK ||
+        HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.FallChannel) != HAL_OK)
+    {
+        pwmCapture_Stop(handle);
+        return PWM_CAPTURE_ERROR;
+    }
     return PWM_CAPTURE_OK;
 }
 
@@ -177,9 +266,139 @@ PwmCaptureState_t pwmCapture_Reset(pwm_Capture_Handle_t *handle)
     memset(&(*handle)->flag, 0, sizeof(pwm_Capture_Flag_t));
     memset(&(*handle)->CCR, 0, sizeof(pwm_Capture_Int_t));
     (*handle)->flag.capSwitch = true;
+    (*handle)->shotsLeft = (*handle)->conf.mode;
     __HAL_TIM_CLEAR_FLAG((*handle)->conf.htim, TIM_FLAG_CC1);
-    HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.RiseChannel);
-    HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.FallChannel);
+    if (HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.RiseChannel) != HAL_OK ||
+        HAL_TIM_IC_Start_IT((*handle)->conf.htim, (*handle)->conf.FallChannel) != HAL_OK)
+    {
+        pwmCapture_Stop(handle);
+        return PWM_CAPTURE_ERROR;
+    }
+    return PWM_CAPTURE_OK;
+}
+
+/**
+ * @brief 快速开启捕获中断，不经过HAL
+ * @note 定时器保持运行，只清除本实例的CCx标志(一次写SR)并置位DIER中的CCxIE，
+ *       同一定时器的其他通道不受影响。通道须已由 pwmCapture_Init/Start 开启
+ *       单次/N次模式下重新装载捕获次数
+ *
+ * @param handle
+ * @return PwmCaptureState_t 操作日志类型 
+ *                      1. PWM_CAPTURE_OK 操作成功  
+ *                      2. PWM_CAPTURE_ERROR 操作失败，可能传入了无效地址
+ */
+PwmCaptureState_t pwmCapture_Arm(pwm_Capture_Handle_t *handle)
+{
+    TIM_TypeDef *tim;
+    uint32_t primask;
+
+    if (handle == NULL || *handle == NULL) return PWM_CAPTURE_ERROR;
+    tim = (*handle)->conf.htim->Instance;
+    (*handle)->flag.isRiseEdge = OFF;
+    (*handle)->flag.isFallEdge = OFF;
+    (*handle)->shotsLeft = (*handle)->conf.mode;
+    (*handle)->flag.capSwitch = true;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    tim->SR = ~(*handle)->itMask;
+    tim->DIER |= (*handle)->itMask;
+    __set_PRIMASK(primask);
+    return PWM_CAPTURE_OK;
+}
+
+/**
+ * @brief 快速关闭捕获中断，不经过HAL
+ * @note 只清除DIER中本实例的CCxIE和SR中的CCx标志，定时器和通道保持开启，
+ *       之后可用 pwmCapture_Arm() 重新开启
+ *
+ * @param handle
+ * @return PwmCaptureState_t 操作日志类型 
+ *                      1. PWM_CAPTURE_OK 操作成功  
+ *                      2. PWM_CAPTURE_ERROR 操作失败，可能传入了无效地址
+ */
+PwmCaptureState_t pwmCapture_Disarm(pwm_Capture_Handle_t *handle)
+{
+    TIM_TypeDef *tim;
+    uint32_t primask;
+
+    if (handle == NULL || *handle == NULL) return PWM_CAPTURE_ERROR;
+    tim = (*handle)->conf.htim->Instance;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    tim->DIER &= ~(*handle)->itMask;
+    tim->SR = ~(*handle)->itMask;
+    __set_PRIMASK(primask);
+
+    (*handle)->flag.capSwitch = false;
+    return PWM_CAPTURE_OK;
+}
+
+/**
+ * @brief 修改捕获模式，关中断写入，不会与捕获中断交错
+ * @note 正在进行的单次/N次捕获按新的次数重新计数，已自动关闭的捕获需调用 pwmCapture_Start() 或 pwmCapture_Arm() 重新开启，
+ *       Start 先经 HAL_TIM_IC_Stop_IT() 复位HAL通道状态再开启，Arm 只置位CCxIE，都会重新装载捕获次数
+ *
+ * @param handle
+ * @param mode 捕获模式 PWM_CAPTURE_MODE_xxx，即自动关闭前的周期数，0 为连续捕获
+ * @return PwmCaptureState_t 操作日志类型 
+ *                      1. PWM_CAPTURE_OK 操作成功  
+ *                      2. PWM_CAPTURE_ERROR 操作失败，可能传入了无效地址
+ */
+PwmCaptureState_t pwmCapture_SetMode(pwm_Capture_Handle_t *handle, uint16_t mode)
+{
+    uint32_t primask;
+
+    if (handle == NULL || *handle == NULL) return PWM_CAPTURE_ERROR;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    (*handle)->conf.mode = mode;
+    (*handle)->shotsLeft = mode;
+    __set_PRIMASK(primask);
+    return PWM_CAPTURE_OK;
+}
+
+/* 通道对应的 CCMRx 寄存器和 ICxF 位置 */
+static __IO uint32_t *pwmCapture_FilterReg(TIM_TypeDef *tim, uint32_t channel, uint32_t *shift)
+{
+    *shift = (channel & TIM_CHANNEL_2) ? 12U : 4U;
+    return (channel & TIM_CHANNEL_3) ? &tim->CCMR2 : &tim->CCMR1;
+}
+
+/**
+ * @brief 修改上升沿和下降沿通道的输入滤波 ICxF，不经过HAL，定时器保持运行
+ *
+ * @param handle
+ * @param filter 滤波设置 0~15，含义见参考手册 TIMx_CCMR1.IC1F
+ * @return PwmCaptureState_t 操作日志类型 
+ *                      1. PWM_CAPTURE_OK 操作成功  
+ *                      2. PWM_CAPTURE_ERROR 操作失败，可能传入了无效地址或滤波设置超出范围
+ */
+PwmCaptureState_t pwmCapture_SetFilter(pwm_Capture_Handle_t *handle, uint8_t filter)
+{
+    TIM_TypeDef *tim;
+    __IO uint32_t *reg;
+    uint32_t shift, primask;
+    uint32_t channel[2];
+    uint8_t i;
+
+    if (handle == NULL || *handle == NULL || filter > 0x0F) return PWM_CAPTURE_ERROR;
+    if ((*handle)->conf.RiseChannel == TIM_CHANNEL_ALL || (*handle)->conf.FallChannel == TIM_CHANNEL_ALL) return PWM_CAPTURE_ERROR;
+    tim = (*handle)->conf.htim->Instance;
+    channel[0] = (*handle)->conf.RiseChannel;
+    channel[1] = (*handle)->conf.FallChannel;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for (i = 0; i < 2; i++)
+    {
+        reg = pwmCapture_FilterReg(tim, channel[i], &shift);
+        *reg = (*reg & ~(0x0FUL << shift)) | ((uint32_t)filter << shift);
+    }
+    __set_PRIMASK(primask);
     return PWM_CAPTURE_OK;
 }
 
@@ -196,7 +415,10 @@ PwmCaptureState_t pwmCapture_Delete(pwm_Capture_Handle_t *handle)
     if (handle == NULL || *handle == NULL) return PWM_CAPTURE_ERROR;
     HAL_TIM_IC_Stop_IT((*handle)->conf.htim, (*handle)->conf.RiseChannel);
     HAL_TIM_IC_Stop_IT((*handle)->conf.htim, (*handle)->conf.FallChannel);
-    free(*handle);
+    if (!(*handle)->isStatic)
+    {
+        free(*handle);
+    }
     *handle = NULL;
     return PWM_CAPTURE_OK;
 }
@@ -249,6 +471,22 @@ uint32_t pwmCapture_getPeriod(pwm_Capture_Handle_t handle)
     return handle->result.period;
 }
 
+/**
+ * @brief 获取上升沿通道当前的输入滤波 ICxF，pwmCapture_SetFilter() 对两个通道写入相同的值
+ *
+ * @param handle
+ * @return uint8_t 滤波设置 0~15，句柄无效时为0
+ */
+uint8_t pwmCapture_getFilter(pwm_Capture_Handle_t handle)
+{
+    uint32_t shift;
+    __IO uint32_t *reg;
+
+    if (handle == NULL || handle->conf.RiseChannel == TIM_CHANNEL_ALL) return 0;
+    reg = pwmCapture_FilterReg(handle->conf.htim->Instance, handle->conf.RiseChannel, &shift);
+    return (uint8_t)((*reg >> shift) & 0x0FUL);
+}
+
 /**
  * @brief 获取捕获是否完成
  * 
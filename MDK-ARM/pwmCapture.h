@@ -25,6 +25,17 @@ extern "C"
 
 #define CAPTURE_TIM_BITS 32 // 定时器最大位宽
 
+#define PWM_CAPTURE_DEFAULT_TICK_HZ 1000000UL // 未配置 tickHz 时的计数频率 1MHz
+
+#ifndef PWM_CAPTURE_TIMESTAMP
+#define PWM_CAPTURE_TIMESTAMP 0 // 为1时用DWT周期计数器记录每个样本对应边沿的时刻，用于测量闭环延迟，每次捕获中断多一次DWT读取、计数器读取和乘法
+#endif
+
+/* 捕获模式: 值为自动关闭前捕获的周期数，0 表示不自动关闭 (连续捕获) */
+#define PWM_CAPTURE_MODE_CONTINUOUS 0U                 // 连续捕获
+#define PWM_CAPTURE_MODE_ONESHOT 1U                    // 捕获一个周期后在中断中自动关闭
+#define PWM_CAPTURE_MODE_NSHOT(n) ((uint16_t)(n))      // 捕获n个周期后在中断中自动关闭，n 为 1~65535，NSHOT(0) 即连续捕获
+
 #define CONCAT(x) uint##x##_t
 #define CAPTURE_TIM_BIT_T(x) CONCAT(x)
 
@@ -41,6 +52,8 @@ typedef struct
     TIM_HandleTypeDef *htim; // 定时器句柄
     uint32_t RiseChannel;    // 捕获上升沿通道
     uint32_t FallChannel;    // 捕获下降沿通道
+    uint32_t tickHz;         // 定时器计数频率 单位: hz，0 表示 PWM_CAPTURE_DEFAULT_TICK_HZ，可由 pwmCapture_timing.h 求解
+    uint16_t mode;           // 捕获模式 PWM_CAPTURE_MODE_xxx，默认连续捕获
 } pwm_Capture_conf_t;
 
 typedef struct
@@ -84,6 +97,16 @@ typedef union
         pwm_Capture_channelMap_t channelMap; // 这个字段不是给你用的
         pwm_Capture_Result_t result;      // 捕获结果
         pwm_Capture_Flag_t flag;          // 标志位
+        bool isStatic;                    // 存储由调用者提供，删除时不释放
+        float tickPeriod;                 // 计数周期 单位: 秒，初始化时由 tickHz 计算
+        uint32_t itMask;                  // 本实例在 DIER/SR 中的 CCx 位
+        uint16_t shotsLeft;               // 单次/N次模式下剩余的捕获次数
+        uint32_t stamp;                   // 上升沿时间戳 单位: 计数值，每个上升沿累加一个周期，连续模式下为绝对时间
+        uint32_t sampleStamp;             // 最近一次完成的捕获对应的上升沿时间戳
+        uint32_t samplePeriod;            // 最近一次完成的捕获的周期 单位: 计数值，CCR在捕获完成后清零，由此读取
+        uint32_t seq;                     // 完成的捕获次数
+        uint32_t sampleCycle;             // 完成捕获的边沿对应的DWT周期计数 (PWM_CAPTURE_TIMESTAMP)
+        uint32_t cyclesPerTick;           // 每个定时器计数对应的CPU周期数
     };
 } pwm_Capture_Class_t;
 
@@ -91,6 +114,8 @@ typedef pwm_Capture_Class_t *pwm_Capture_Handle_t; // 捕获句柄类型
 
 PwmCaptureState_t pwmCapture_Init(pwm_Capture_Handle_t *handle, pwm_Capture_conf_t *conf);
 
+PwmCaptureState_t pwmCapture_InitStatic(pwm_Capture_Handle_t *handle, pwm_Capture_Class_t *obj, pwm_Capture_conf_t *conf);
+
 void pwmCapture_Callback(pwm_Capture_Handle_t *pwm_Cap_handle, TIM_HandleTypeDef *htim);
 
 PwmCaptureState_t pwmCapture_Delete(pwm_Capture_Handle_t *handle);
@@ -101,6 +126,14 @@ PwmCaptureState_t pwmCapture_Start(pwm_Capture_Handle_t *handle);
 
 PwmCaptureState_t pwmCapture_Reset(pwm_Capture_Handle_t *handle);
 
+PwmCaptureState_t pwmCapture_Arm(pwm_Capture_Handle_t *handle);
+
+PwmCaptureState_t pwmCapture_Disarm(pwm_Capture_Handle_t *handle);
+
+PwmCaptureState_t pwmCapture_SetMode(pwm_Capture_Handle_t *handle, uint16_t mode);
+
+PwmCaptureState_t pwmCapture_SetFilter(pwm_Capture_Handle_t *handle, uint8_t filter);
+
 PwmCaptureState_t pwmCapture_Delete(pwm_Capture_Handle_t *handle);
 
 uint32_t pwmCapture_getPulseWidth(pwm_Capture_Handle_t handle);
@@ -111,6 +144,8 @@ float pwmCapture_getDuty(pwm_Capture_Handle_t handle);
 
 uint32_t pwmCapture_getPeriod(pwm_Capture_Handle_t handle);
 
+uint8_t pwmCapture_getFilter(pwm_Capture_Handle_t handle);
+
 bool pwmCapture_getComplete(pwm_Capture_Handle_t *handle);
 
 #ifdef __cplusplus
@@ -0,0 +1,98 @@
+#ifndef PWMCAPTURE_HPP
+#define PWMCAPTURE_HPP
+
+/**
+ * @file pwmCapture.hpp
+ * @author xfp23
+ * @brief pwmCapture 的C++封装 (C++11)
+ * @note 构造时开启捕获，析构时停止捕获；实例存储在对象内部，不使用堆
+ *       对象只能移动不能拷贝，不要在捕获中断可能触发时移动对象
+ *       getter 直接读取结果字段并内联展开，不经过函数调用；构造函数也内联展开，调用方代码可能比C接口大，
+ *       与C接口的体积对比见 Bench 的 size_report
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "pwmCapture.h"
+
+#if __cplusplus >= 201703L
+#define PWM_CAPTURE_NODISCARD [[nodiscard]]
+#else
+#define PWM_CAPTURE_NODISCARD
+#endif
+
+class PwmCapture
+{
+public:
+    explicit PwmCapture(const pwm_Capture_conf_t &conf) : handle_(NULL)
+    {
+        pwm_Capture_conf_t c = conf;
+        state_ = pwmCapture_InitStatic(&handle_, &obj_, &c);
+    }
+
+    ~PwmCapture()
+    {
+        if (handle_ != NULL)
+        {
+            pwmCapture_Stop(&handle_);
+        }
+    }
+
+    PwmCapture(PwmCapture &&other) : obj_(other.obj_), handle_(NULL), state_(other.state_)
+    {
+        if (other.handle_ != NULL)
+        {
+            handle_ = &obj_;
+            other.handle_ = NULL;
+        }
+    }
+
+    PwmCapture &operator=(PwmCapture &&other)
+    {
+        if (this != &other)
+        {
+            if (handle_ != NULL)
+            {
+                pwmCapture_Stop(&handle_);
+            }
+            obj_ = other.obj_;
+            state_ = other.state_;
+            handle_ = (other.handle_ != NULL) ? &obj_ : NULL;
+            other.handle_ = NULL;
+        }
+        return *this;
+    }
+
+    PwmCapture(const PwmCapture &) = delete;
+    PwmCapture &operator=(const PwmCapture &) = delete;
+
+    /* 在 HAL_TIM_IC_CaptureCallback() 中调用 */
+    void callback(TIM_HandleTypeDef *htim) { pwmCapture_Callback(&handle_, htim); }
+
+    PwmCaptureState_t start() { return pwmCapture_Start(&handle_); }
+    PwmCaptureState_t stop() { return pwmCapture_Stop(&handle_); }
+    PwmCaptureState_t reset() { return pwmCapture_Reset(&handle_); }
+
+    PWM_CAPTURE_NODISCARD PwmCaptureState_t state() const { return state_; }
+    PWM_CAPTURE_NODISCARD bool valid() const { return handle_ != NULL && state_ == PWM_CAPTURE_OK; }
+
+    /* 读取并清除完成标志，走C接口以保证每次都重新读取标志位 */
+    PWM_CAPTURE_NODISCARD bool complete() { return pwmCapture_getComplete(&handle_); }
+
+    PWM_CAPTURE_NODISCARD uint32_t freq() const { return obj_.result.freq; }
+    PWM_CAPTURE_NODISCARD uint32_t pulseWidth() const { return obj_.result.pulseWidth; }
+    PWM_CAPTURE_NODISCARD float duty() const { return obj_.result.duty; }
+    PWM_CAPTURE_NODISCARD uint32_t period() const { return obj_.result.period; }
+
+    /* 需要与C接口混用时取句柄 */
+    PWM_CAPTURE_NODISCARD pwm_Capture_Handle_t handle() const { return handle_; }
+
+private:
+    pwm_Capture_Class_t obj_;
+    pwm_Capture_Handle_t handle_;
+    PwmCaptureState_t state_;
+};
+
+#endif // !PWMCAPTURE_HPP
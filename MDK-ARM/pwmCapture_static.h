@@ -0,0 +1,145 @@
+#ifndef PWMCAPTURE_STATIC_H
+#define PWMCAPTURE_STATIC_H
+
+/**
+ * @file pwmCapture_static.h
+ * @author xfp23
+ * @brief 编译期特化的pwm捕获实例
+ * @note 定时器和通道在编译期确定，中断里没有通道映射和句柄指针，寄存器地址和标志位都是常量
+ *       1. 在头文件中 PWM_CAPTURE_DEFINE(pwmCap, TIM1, CH1, CH2) 生成实例的内联函数
+ *       2. 在一个.c文件中 PWM_CAPTURE_INSTANCE(pwmCap) 定义实例的存储
+ *       3. 在 TIM1_CC_IRQHandler() 中调用 pwmCap_IRQHandler() 代替 HAL_TIM_IRQHandler()
+ *       定时器的初始化(输入捕获、从模式复位)仍由CubeMX生成的代码完成
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "pwmCapture.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+/* 通道 -> 寄存器 / 标志位 */
+#define PWM_CAPTURE_CCR_CH1 CCR1
+#define PWM_CAPTURE_CCR_CH2 CCR2
+#define PWM_CAPTURE_CCR_CH3 CCR3
+#define PWM_CAPTURE_CCR_CH4 CCR4
+
+#define PWM_CAPTURE_FLAG_CH1 TIM_FLAG_CC1 // SR中的CCxIF与DIER中的CCxIE位置相同
+#define PWM_CAPTURE_FLAG_CH2 TIM_FLAG_CC2
+#define PWM_CAPTURE_FLAG_CH3 TIM_FLAG_CC3
+#define PWM_CAPTURE_FLAG_CH4 TIM_FLAG_CC4
+
+#define PWM_CAPTURE_CCER_CH1 TIM_CCER_CC1E
+#define PWM_CAPTURE_CCER_CH2 TIM_CCER_CC2E
+#define PWM_CAPTURE_CCER_CH3 TIM_CCER_CC3E
+#define PWM_CAPTURE_CCER_CH4 TIM_CCER_CC4E
+
+typedef struct
+{
+    pwm_Capture_Int_t CCR;          // 寄存器值
+    pwm_Capture_Result_t result;    // 捕获结果
+    volatile uint8_t isRiseEdge;
+    volatile uint8_t isFallEdge;
+    volatile uint8_t isCapComplete; // 捕获完成
+} pwm_Capture_Static_t;
+
+/**
+ * @brief 计算捕获结果，与 pwmCapture_Callback() 中的计算一致
+ */
+static inline void pwmCapture_StaticCompute(pwm_Capture_Result_t *result, capture_timbits_t ccr1, capture_timbits_t ccr2, uint32_t tickHz)
+{
+    result->period = (float)ccr1 / (float)tickHz;
+    result->duty = ((float)ccr2 / (float)ccr1) * 100;
+    result->pulseWidth = ccr2;
+    result->freq = (ccr1 != 0) ? tickHz / ccr1 : 0;
+}
+
+/**
+ * @brief 定义编译期特化的捕获实例
+ *
+ * @param name 实例名，生成 name_Start/Stop/IRQHandler/getXXX 函数
+ * @param TIMx 定时器 如 TIM1
+ * @param RISE 上升沿通道 CH1 ~ CH4
+ * @param FALL 下降沿通道 CH1 ~ CH4
+ * @param TICK_HZ 定时器计数频率 单位: hz，编译期常量
+ */
+#define PWM_CAPTURE_DEFINE_EX(name, TIMx, RISE, FALL, TICK_HZ)                                  \
+    extern pwm_Capture_Static_t name;                                                           \
+                                                                                                \
+    static inline void name##_Start(void)                                                       \
+    {                                                                                           \
+        name.isRiseEdge = 0;                                                                    \
+        name.isFallEdge = 0;                                                                    \
+        (TIMx)->SR = ~(uint32_t)(PWM_CAPTURE_FLAG_##RISE | PWM_CAPTURE_FLAG_##FALL);            \
+        (TIMx)->CCER |= PWM_CAPTURE_CCER_##RISE | PWM_CAPTURE_CCER_##FALL;                      \
+        (TIMx)->DIER |= PWM_CAPTURE_FLAG_##RISE | PWM_CAPTURE_FLAG_##FALL;                      \
+        (TIMx)->CR1 |= TIM_CR1_CEN;                                                             \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_Stop(void)                                                        \
+    {                                                                                           \
+        (TIMx)->DIER &= ~(uint32_t)(PWM_CAPTURE_FLAG_##RISE | PWM_CAPTURE_FLAG_##FALL);         \
+        (TIMx)->CCER &= ~(uint32_t)(PWM_CAPTURE_CCER_##RISE | PWM_CAPTURE_CCER_##FALL);         \
+        (TIMx)->SR = ~(uint32_t)(PWM_CAPTURE_FLAG_##RISE | PWM_CAPTURE_FLAG_##FALL);            \
+        name.isCapComplete = 0;                                                                 \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_IRQHandler(void)                                                  \
+    {                                                                                           \
+        uint32_t sr = (TIMx)->SR & (PWM_CAPTURE_FLAG_##RISE | PWM_CAPTURE_FLAG_##FALL);         \
+        (TIMx)->SR = ~sr;                                                                       \
+        /* 下降沿先于上升沿发生，两者同时挂起时先处理下降沿 */                                  \
+        if (sr & PWM_CAPTURE_FLAG_##FALL)                                                       \
+        {                                                                                       \
+            name.CCR.CCR2 = (TIMx)->PWM_CAPTURE_CCR_##FALL;                                     \
+            name.isFallEdge = 1;                                                                \
+        }                                                                                       \
+        if (sr & PWM_CAPTURE_FLAG_##RISE)                                                       \
+        {                                                                                       \
+            name.CCR.CCR1 = (TIMx)->PWM_CAPTURE_CCR_##RISE;                                     \
+            name.isRiseEdge = 1;                                                                \
+        }                                                                                       \
+        if (name.isRiseEdge && name.isFallEdge)                                                 \
+        {                                                                                       \
+            name.isRiseEdge = 0;                                                                \
+            name.isFallEdge = 0;                                                                \
+            pwmCapture_StaticCompute(&name.result, name.CCR.CCR1, name.CCR.CCR2, TICK_HZ);      \
+            name.isCapComplete = 1;                                                             \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    static inline bool name##_getComplete(void)                                                 \
+    {                                                                                           \
+        if (name.isCapComplete)                                                                 \
+        {                                                                                       \
+            name.isCapComplete = 0;                                                             \
+            return true;                                                                        \
+        }                                                                                       \
+        return false;                                                                           \
+    }                                                                                           \
+                                                                                                \
+    static inline uint32_t name##_getFreq(void) { return name.result.freq; }                    \
+    static inline uint32_t name##_getPulseWidth(void) { return name.result.pulseWidth; }        \
+    static inline float name##_getDuty(void) { return name.result.duty; }                       \
+    static inline uint32_t name##_getPeriod(void) { return name.result.period; }
+
+/**
+ * @brief 定义编译期特化的捕获实例，计数频率为 PWM_CAPTURE_DEFAULT_TICK_HZ
+ */
+#define PWM_CAPTURE_DEFINE(name, TIMx, RISE, FALL) \
+    PWM_CAPTURE_DEFINE_EX(name, TIMx, RISE, FALL, PWM_CAPTURE_DEFAULT_TICK_HZ)
+
+/**
+ * @brief 定义实例的存储，只能在一个.c文件中使用
+ */
+#define PWM_CAPTURE_INSTANCE(name) pwm_Capture_Static_t name
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !PWMCAPTURE_STATIC_H
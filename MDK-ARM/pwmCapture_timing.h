@@ -0,0 +1,72 @@
+#ifndef PWMCAPTURE_TIMING_H
+#define PWMCAPTURE_TIMING_H
+
+/**
+ * @file pwmCapture_timing.h
+ * @author xfp23
+ * @brief 捕获定时器分频/重装载值的编译期求解
+ * @note 输入: 定时器时钟、最低/最高输入频率、最高频率下一个周期内至少需要的计数值(分辨率)
+ *       输出: PSC、ARR 以及 pwmCapture 使用的计数频率 tickHz
+ *       参数组合无法满足时编译报错 (数组长度为负)
+ *       定时器工作在从模式复位下，ARR取16位最大值，最低频率的一个周期必须放得下
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#define PWM_CAPTURE_TIM_MAX 65535UL // 16位定时器 PSC/ARR 最大值
+
+/* 预分频值: 计数频率不低于 fMax * res 的最大分频 */
+#define PWM_CAPTURE_CALC_PSC(clk, fMax, res) ((unsigned long)(clk) / ((unsigned long)(fMax) * (res)) - 1UL)
+
+/* 重装载值 */
+#define PWM_CAPTURE_CALC_ARR(clk, fMin, fMax, res) PWM_CAPTURE_TIM_MAX
+
+/* 计数频率 单位: hz，赋值给 pwm_Capture_conf_t.tickHz */
+#define PWM_CAPTURE_CALC_TICK_HZ(clk, fMax, res) ((unsigned long)(clk) / (PWM_CAPTURE_CALC_PSC(clk, fMax, res) + 1UL))
+
+/* 类型名拼接行号，同一文件内多次检查不会重复定义 */
+#define PWM_CAPTURE_CAT_(a, b) a##b
+#define PWM_CAPTURE_CAT(a, b) PWM_CAPTURE_CAT_(a, b)
+#define PWM_CAPTURE_STATIC_ASSERT(cond, msg) \
+    typedef char PWM_CAPTURE_CAT(pwm_capture_assert_##msg##_, __LINE__)[(cond) ? 1 : -1]
+
+/**
+ * @brief 检查参数组合，放在任意.c文件的文件作用域
+ * @note 同一文件可检查多组参数，每次检查需单独占一行
+ *
+ * @param clk 定时器时钟 单位: hz
+ * @param fMin 最低输入频率 单位: hz
+ * @param fMax 最高输入频率 单位: hz
+ * @param res 最高频率时一个周期的最少计数值
+ */
+#define PWM_CAPTURE_TIMING_CHECK(clk, fMin, fMax, res)                                                             \
+    PWM_CAPTURE_STATIC_ASSERT((fMin) > 0 && (fMin) <= (fMax), freq_range_invalid);                                 \
+    PWM_CAPTURE_STATIC_ASSERT((unsigned long)(clk) / ((unsigned long)(fMax) * (res)) >= 1UL, resolution_too_high); \
+    PWM_CAPTURE_STATIC_ASSERT(PWM_CAPTURE_CALC_PSC(clk, fMax, res) <= PWM_CAPTURE_TIM_MAX, prescaler_overflow);    \
+    PWM_CAPTURE_STATIC_ASSERT(PWM_CAPTURE_CALC_TICK_HZ(clk, fMax, res) / (fMin) <= PWM_CAPTURE_TIM_MAX, freq_min_too_low)
+
+#ifdef __cplusplus
+
+/* C++: 同样的求解，参数不满足时 static_assert 报错
+ * main.h 在 extern "C" 中包含本文件，模板需要显式声明为 C++ 链接 */
+extern "C++" {
+template <unsigned long Clk, unsigned long FMin, unsigned long FMax, unsigned long Res>
+struct PwmCaptureTiming
+{
+    static_assert(FMin > 0 && FMin <= FMax, "frequency range invalid");
+    static_assert(Clk / (FMax * Res) >= 1UL, "resolution too high for timer clock");
+
+    static constexpr unsigned long psc = PWM_CAPTURE_CALC_PSC(Clk, FMax, Res);
+    static constexpr unsigned long arr = PWM_CAPTURE_CALC_ARR(Clk, FMin, FMax, Res);
+    static constexpr unsigned long tickHz = PWM_CAPTURE_CALC_TICK_HZ(Clk, FMax, Res);
+
+    static_assert(psc <= PWM_CAPTURE_TIM_MAX, "prescaler overflow");
+    static_assert(tickHz / FMin <= PWM_CAPTURE_TIM_MAX, "lowest frequency period does not fit the counter");
+};
+}
+
+#endif // __cplusplus
+#endif // !PWMCAPTURE_TIMING_H
@@ -0,0 +1,325 @@
+#include "telemetry.h"
+#include "stdlib.h"
+#include "string.h"
+
+/* 小端写入 */
+static void telemetry_Put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void telemetry_PutFloat(uint8_t *p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    telemetry_Put32(p, v);
+}
+
+/* 取下一段连续的待发送数据并标记为发送中，需关中断调用 */
+static uint16_t telemetry_NextChunk(telemetry_Class_t *t)
+{
+    uint16_t head = t->head, tail = t->tail;
+
+    if (head == tail)
+    {
+        t->busy = false;
+        return 0;
+    }
+
+    t->inFlight = (head > tail) ? (uint16_t)(head - tail) : (uint16_t)(t->conf.size - tail);
+    t->busy = true;
+    return t->inFlight;
+}
+
+/* 启动DMA，失败时释放发送权，数据留在缓冲区等待下一次写入 */
+static void telemetry_Start(telemetry_Class_t *t, uint16_t len)
+{
+    uint32_t primask;
+
+    if (HAL_UART_Transmit_DMA(t->conf.huart, &t->conf.buf[t->tail], len) != HAL_OK)
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        t->inFlight = 0;
+        t->busy = false;
+        __set_PRIMASK(primask);
+    }
+}
+
+/**
+ * @brief 初始化遥测
+ *
+ * @param handle 句柄
+ * @param conf 配置
+ * @return TelemetryState_t 操作日志类型
+ *                      1. TELEMETRY_OK 操作成功
+ *                      2. TELEMETRY_ERROR 操作失败，可能传入了无效地址、缓冲区长度不是2的幂或小于一帧
+ *                      3. TELEMETRY_INITIALIZED 传入了一个已经存在的实例
+ */
+TelemetryState_t telemetry_Init(telemetry_Handle_t *handle, telemetry_conf_t *conf)
+{
+    if (handle == NULL || *handle != NULL)
+    {
+        return TELEMETRY_INITIALIZED;
+    }
+
+    if (conf == NULL || conf->huart == NULL || conf->buf == NULL || conf->size <= TELEMETRY_FRAME_MAX || (conf->size & (conf->size - 1)) != 0)
+    {
+        return TELEMETRY_ERROR;
+    }
+
+    *handle = calloc(1, sizeof(telemetry_Class_t));
+    if (*handle == NULL)
+    {
+        return TELEMETRY_ERROR;
+    }
+
+    memcpy(&(*handle)->conf, conf, sizeof(telemetry_conf_t));
+    telemetryCodec_Init();
+    return TELEMETRY_OK;
+}
+
+/**
+ * @brief 组帧并写入缓冲区，可在中断中调用
+ *
+ * @param handle 句柄
+ * @param type 帧类型
+ * @param payload 负载
+ * @param len 负载长度，不超过 TELEMETRY_PAYLOAD_MAX
+ * @return TelemetryState_t 操作日志类型
+ *                      1. TELEMETRY_OK 已写入缓冲区
+ *                      2. TELEMETRY_FULL 缓冲区满，帧已丢弃
+ *                      3. TELEMETRY_ERROR 操作失败
+ */
+TelemetryState_t telemetry_Push(telemetry_Handle_t *handle, uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    telemetry_Class_t *t;
+    uint16_t mask, head, used, n, first, kick = 0;
+    uint32_t primask;
+
+    if (handle == NULL || *handle == NULL) return TELEMETRY_ERROR;
+    t = *handle;
+    mask = t->conf.size - 1;
+
+    // 编码在临界区外完成，临界区内只拷贝
+    n = telemetryCodec_Frame(type, payload, len, frame);
+    if (n == 0) return TELEMETRY_ERROR;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    head = t->head;
+    used = (uint16_t)(head - t->tail) & mask;
+    if ((uint16_t)(mask - used) < n)
+    {
+        t->dropped++;
+        __set_PRIMASK(primask);
+        return TELEMETRY_FULL;
+    }
+
+    first = t->conf.size - head;
+    if (first > n) first = n;
+    memcpy(&t->conf.buf[head], frame, first);
+    memcpy(t->conf.buf, &frame[first], n - first);
+    t->head = (head + n) & mask;
+    t->frames++;
+
+    if (!t->busy)
+    {
+        kick = telemetry_NextChunk(t);
+    }
+    __set_PRIMASK(primask);
+
+    if (kick)
+    {
+        telemetry_Start(t, kick);
+    }
+    return TELEMETRY_OK;
+}
+
+/**
+ * @brief 有新的捕获样本时写入一个采样帧
+ *
+ * @param handle 句柄
+ * @param cap 捕获句柄
+ * @param pid 控制器句柄，可为NULL
+ * @return TelemetryState_t 操作日志类型
+ *                      1. TELEMETRY_OK 已写入缓冲区
+ *                      2. TELEMETRY_NO_SAMPLE 没有新样本
+ *                      3. TELEMETRY_FULL 缓冲区满，帧已丢弃
+ *                      4. TELEMETRY_ERROR 操作失败
+ */
+TelemetryState_t telemetry_PushSample(telemetry_Handle_t *handle, pwm_Capture_Handle_t *cap, PIDController_Handle_t *pid)
+{
+    uint8_t payload[TELEMETRY_SAMPLE_LEN_PID];
+    pwm_Capture_Handle_t c;
+    uint32_t seq, stamp, period, high, primask;
+    uint8_t len = TELEMETRY_SAMPLE_LEN_CAP;
+
+    if (handle == NULL || *handle == NULL || cap == NULL || *cap == NULL) return TELEMETRY_ERROR;
+    c = *cap;
+
+    // 取样本快照，避免读到一半时被捕获中断更新
+    primask = __get_PRIMASK();
+    __disable_irq();
+    seq = c->seq;
+    stamp = c->sampleStamp;
+    period = c->samplePeriod;
+    high = c->result.pulseWidth;
+    if (pid != NULL && *pid != NULL)
+    {
+        telemetry_PutFloat(&payload[16], (*pid)->out);
+        telemetry_PutFloat(&payload[20], (*pid)->integrator);
+        telemetry_PutFloat(&payload[24], (*pid)->prevMeasurement);
+        len = TELEMETRY_SAMPLE_LEN_PID;
+    }
+    __set_PRIMASK(primask);
+
+    if (seq == (*handle)->lastSeq) return TELEMETRY_NO_SAMPLE;
+    (*handle)->lastSeq = seq;
+
+    telemetry_Put32(&payload[0], seq);
+    telemetry_Put32(&payload[4], stamp);
+    telemetry_Put32(&payload[8], period);
+    telemetry_Put32(&payload[12], high);
+    return telemetry_Push(handle, TELEMETRY_FRAME_SAMPLE, payload, len);
+}
+
+/**
+ * @brief 有新的捕获样本时加入批量差分帧，攒够 conf.batch 个样本后写入缓冲区
+ * @note 同一实例只能在一个上下文中调用，一般放在 HAL_TIM_IC_CaptureCallback() 中紧跟 pwmCapture_Callback()
+ *
+ * @param handle 句柄
+ * @param cap 捕获句柄
+ * @return TelemetryState_t 操作日志类型
+ *                      1. TELEMETRY_OK 已加入，或已组帧写入缓冲区
+ *                      2. TELEMETRY_NO_SAMPLE 没有新样本
+ *                      3. TELEMETRY_FULL 缓冲区满，整批已丢弃
+ *                      4. TELEMETRY_ERROR 操作失败
+ */
+TelemetryState_t telemetry_PushDelta(telemetry_Handle_t *handle, pwm_Capture_Handle_t *cap)
+{
+    telemetry_Class_t *t;
+    pwm_Capture_Handle_t c;
+    uint32_t seq, stamp, period, high, primask;
+    uint8_t *p;
+    uint8_t batch;
+
+    if (handle == NULL || *handle == NULL || cap == NULL || *cap == NULL) return TELEMETRY_ERROR;
+    t = *handle;
+    c = *cap;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    seq = c->seq;
+    stamp = c->sampleStamp;
+    period = c->samplePeriod;
+    high = c->result.pulseWidth;
+    __set_PRIMASK(primask);
+
+    if (t->deltaStarted && seq == t->prevSeq) return TELEMETRY_NO_SAMPLE;
+    t->deltaStarted = true;
+
+    p = &t->batchBuf[t->batchLen];
+    if (t->batchCount == 0)
+    {
+        // 每帧第一个样本为绝对值
+        p = &t->batchBuf[1];
+        p += telemetryCodec_PutVarint(p, seq);
+        p += telemetryCodec_PutVarint(p, stamp);
+        p += telemetryCodec_PutVarint(p, period);
+        p += telemetryCodec_PutVarint(p, high);
+    }
+    else
+    {
+        p += telemetryCodec_PutVarint(p, seq - t->prevSeq);
+        p += telemetryCodec_PutVarint(p, TELEMETRY_ZIGZAG(stamp - t->prevStamp - period));
+        p += telemetryCodec_PutVarint(p, TELEMETRY_ZIGZAG(period - t->prevPeriod));
+        p += telemetryCodec_PutVarint(p, TELEMETRY_ZIGZAG(high - t->prevHigh));
+    }
+    t->batchLen = (uint8_t)(p - t->batchBuf);
+    t->batchBuf[0] = ++t->batchCount;
+    t->prevSeq = seq;
+    t->prevStamp = stamp;
+    t->prevPeriod = period;
+    t->prevHigh = high;
+
+    batch = t->conf.batch ? t->conf.batch : TELEMETRY_BATCH_DEFAULT;
+    if (t->batchCount >= batch || t->batchLen + TELEMETRY_BATCH_ENTRY_MAX > TELEMETRY_PAYLOAD_MAX)
+    {
+        return telemetry_Flush(handle);
+    }
+    return TELEMETRY_OK;
+}
+
+/**
+ * @brief 把未攒满的批量差分帧写入缓冲区
+ *
+ * @param handle 句柄
+ * @return TelemetryState_t 操作日志类型
+ */
+TelemetryState_t telemetry_Flush(telemetry_Handle_t *handle)
+{
+    telemetry_Class_t *t;
+    uint8_t len;
+
+    if (handle == NULL || *handle == NULL) return TELEMETRY_ERROR;
+    t = *handle;
+    if (t->batchCount == 0) return TELEMETRY_OK;
+
+    len = t->batchLen;
+    t->batchCount = 0;
+    t->batchLen = 0;
+    return telemetry_Push(handle, TELEMETRY_FRAME_BATCH, t->batchBuf, len);
+}
+
+/**
+ * @brief 发送完成，接着发送缓冲区中剩余的数据
+ * @note 在 HAL_UART_TxCpltCallback() 中调用
+ *
+ * @param handle 句柄
+ * @param huart 传入 HAL_UART_TxCpltCallback() 的形参
+ */
+void telemetry_TxCpltCallback(telemetry_Handle_t *handle, UART_HandleTypeDef *huart)
+{
+    telemetry_Class_t *t;
+    uint16_t kick;
+    uint32_t primask;
+
+    if (handle == NULL || *handle == NULL || huart != (*handle)->conf.huart) return;
+    t = *handle;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    t->tail = (t->tail + t->inFlight) & (t->conf.size - 1);
+    t->inFlight = 0;
+    kick = telemetry_NextChunk(t);
+    __set_PRIMASK(primask);
+
+    if (kick)
+    {
+        telemetry_Start(t, kick);
+    }
+}
+
+/**
+ * @brief 删除遥测，正在进行的DMA发送会被中止
+ *
+ * @param handle 句柄
+ * @return TelemetryState_t 操作日志类型
+ */
+TelemetryState_t telemetry_Delete(telemetry_Handle_t *handle)
+{
+    if (handle == NULL || *handle == NULL) return TELEMETRY_ERROR;
+    if ((*handle)->busy)
+    {
+        HAL_UART_AbortTransmit((*handle)->conf.huart);
+    }
+    free(*handle);
+    *handle = NULL;
+    return TELEMETRY_OK;
+}
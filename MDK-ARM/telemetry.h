@@ -0,0 +1,123 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/**
+ * @file telemetry.h
+ * @author xfp23
+ * @brief 捕获结果与PID状态的串口遥测，DMA发送，不阻塞
+ * @note 帧先写入环形缓冲区，空闲时用 HAL_UART_Transmit_DMA() 发出缓冲区中连续的一段，
+ *       发送完成回调 HAL_UART_TxCpltCallback() 中调用 telemetry_TxCpltCallback() 接着发下一段
+ *       写入和回调都只在关中断下拷贝一帧，主循环和中断都不会等待串口
+ *       缓冲区满时整帧丢弃并计数，缓冲区由调用者提供，长度为2的幂
+ *       帧格式见 telemetryCodec.h，采样帧约 37 字节，批量差分帧每个样本约 4~5 字节，
+ *       115200 波特率下分别约 300 帧每秒和 2000 多个样本每秒
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+#include "pwmCapture.h"
+#include "PID.h"
+#include "telemetryCodec.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+#ifndef TELEMETRY_BATCH_DEFAULT
+#define TELEMETRY_BATCH_DEFAULT 16 // 批量差分帧默认样本数
+#endif
+
+typedef enum
+{
+    TELEMETRY_FRAME_SAMPLE = 0x01, // 捕获样本 + PID状态
+    TELEMETRY_FRAME_BATCH = 0x02,  // 多个捕获样本，差分 + varint 编码
+    TELEMETRY_FRAME_ACK = 0x03,    // 命令应答 uint8_t cmd, uint8_t status，见 cmdChannel.h
+} telemetry_FrameType_t;
+
+/*
+ * TELEMETRY_FRAME_SAMPLE 负载，小端:
+ *   uint32_t seq        捕获序号
+ *   uint32_t stamp      上升沿时间戳 单位: 计数值
+ *   uint32_t period     周期 单位: 计数值 (samplePeriod)
+ *   uint32_t high       高电平时间 单位: 计数值 (result.pulseWidth)
+ *   float    out        PID输出        (未传入PID时不发送以下三项)
+ *   float    integrator PID积分项
+ *   float    measurement PID上次测量值
+ *
+ * TELEMETRY_FRAME_BATCH 负载:
+ *   uint8_t  count      样本数
+ *   varint   seq, stamp, period, high           第一个样本，绝对值
+ *   之后每个样本:
+ *   varint   seq - 上一个seq
+ *   zigzag   stamp - 上一个stamp - period       连续模式下一般为0
+ *   zigzag   period - 上一个period
+ *   zigzag   high - 上一个high
+ *   每帧的第一个样本为绝对值，丢帧不影响后面的帧解码
+ */
+#define TELEMETRY_SAMPLE_LEN_CAP 16
+#define TELEMETRY_SAMPLE_LEN_PID 28
+#define TELEMETRY_BATCH_ENTRY_MAX 20 // 一个样本编码后最大长度
+
+typedef struct
+{
+    UART_HandleTypeDef *huart; // 串口句柄，需配置DMA发送
+    uint8_t *buf;              // 环形缓冲区
+    uint16_t size;             // 缓冲区长度，2的幂
+    uint8_t batch;             // 批量差分帧的样本数，0 表示 TELEMETRY_BATCH_DEFAULT
+} telemetry_conf_t;
+
+typedef struct
+{
+    telemetry_conf_t conf;   // 配置
+    volatile uint16_t head;  // 写入位置
+    volatile uint16_t tail;  // 发送位置
+    volatile uint16_t inFlight; // 正在发送的字节数
+    volatile bool busy;      // DMA发送中
+    uint32_t frames;         // 写入的帧数
+    uint32_t dropped;        // 缓冲区满丢弃的帧数
+    uint32_t lastSeq;        // 上次发送的捕获序号
+
+    /* 批量差分帧，只在一个上下文中写入 */
+    uint8_t batchBuf[TELEMETRY_PAYLOAD_MAX];
+    uint8_t batchLen;        // 已编码长度
+    uint8_t batchCount;      // 已编码样本数
+    bool deltaStarted;       // 已有第一个样本
+    uint32_t prevSeq;        // 上一个样本
+    uint32_t prevStamp;
+    uint32_t prevPeriod;
+    uint32_t prevHigh;
+} telemetry_Class_t;
+
+typedef telemetry_Class_t *telemetry_Handle_t; // 遥测句柄
+
+typedef enum
+{
+    TELEMETRY_OK = 0x00,          // 操作成功
+    TELEMETRY_ERROR = 0xFF,       // 操作失败
+    TELEMETRY_INITIALIZED = 0x01, // 已初始化
+    TELEMETRY_FULL = 0x02,        // 缓冲区满，帧已丢弃
+    TELEMETRY_NO_SAMPLE = 0x03,   // 没有新的捕获样本
+} TelemetryState_t;
+
+TelemetryState_t telemetry_Init(telemetry_Handle_t *handle, telemetry_conf_t *conf);
+
+TelemetryState_t telemetry_Push(telemetry_Handle_t *handle, uint8_t type, const uint8_t *payload, uint8_t len);
+
+TelemetryState_t telemetry_PushSample(telemetry_Handle_t *handle, pwm_Capture_Handle_t *cap, PIDController_Handle_t *pid);
+
+TelemetryState_t telemetry_PushDelta(telemetry_Handle_t *handle, pwm_Capture_Handle_t *cap);
+
+TelemetryState_t telemetry_Flush(telemetry_Handle_t *handle);
+
+void telemetry_TxCpltCallback(telemetry_Handle_t *handle, UART_HandleTypeDef *huart);
+
+TelemetryState_t telemetry_Delete(telemetry_Handle_t *handle);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !TELEMETRY_H
@@ -0,0 +1,62 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+/**
+ * @file telemetryCodec.h
+ * @author xfp23
+ * @brief 遥测帧编解码: COBS 分帧 + CRC32 校验 + varint 编码
+ * @note 帧格式: COBS( type | payload | crc32 ) | 0x00
+ *       COBS 编码后帧内不含 0x00，0x00 只作为帧尾，接收方丢字节后从下一个 0x00 重新同步
+ *       crc32 为 STM32 CRC 单元的算法 (多项式 0x04C11DB7，初值 0xFFFFFFFF，不反转，无输出异或)，
+ *       按小端32位字计算，最后不足4字节的部分补0，结果小端存放
+ *       有CRC外设时用硬件计算，否则查表，两者结果相同，主机端也用本文件解码
+ * @version 0.1
+ * @date 2025-03-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+#ifndef TELEMETRY_CRC_HW
+#ifdef CRC
+#define TELEMETRY_CRC_HW 1 // 使用CRC外设
+#else
+#define TELEMETRY_CRC_HW 0 // 查表
+#endif
+#endif
+
+#define TELEMETRY_PAYLOAD_MAX 96 // 最大负载长度
+
+#define TELEMETRY_RAW_MAX (TELEMETRY_PAYLOAD_MAX + 5) // type + payload + crc32
+
+#define TELEMETRY_FRAME_MAX (TELEMETRY_RAW_MAX + TELEMETRY_RAW_MAX / 254 + 2) // 编码后最大长度，含帧尾
+
+#define TELEMETRY_ZIGZAG(x) (((uint32_t)(x) << 1) ^ (uint32_t)((int32_t)(x) >> 31)) // 有符号数转为小的无符号数
+#define TELEMETRY_UNZIGZAG(x) ((int32_t)((x) >> 1) ^ -(int32_t)((x) & 1U))
+
+void telemetryCodec_Init(void);
+
+uint32_t telemetryCodec_Crc32(const uint8_t *data, uint16_t len);
+
+uint16_t telemetryCodec_CobsEncode(const uint8_t *in, uint16_t len, uint8_t *out);
+
+uint16_t telemetryCodec_CobsDecode(const uint8_t *in, uint16_t len, uint8_t *out);
+
+uint8_t telemetryCodec_PutVarint(uint8_t *p, uint32_t v);
+
+uint8_t telemetryCodec_GetVarint(const uint8_t *p, uint16_t len, uint32_t *v);
+
+uint16_t telemetryCodec_Frame(uint8_t type, const uint8_t *payload, uint16_t len, uint8_t *out);
+
+uint16_t telemetryCodec_Unframe(const uint8_t *in, uint16_t len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif // !TELEMETRY_CODEC_H